@@ -0,0 +1,638 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2017 Ron Economos.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Offline encoder, TS file in and I/Q file out, as fast as the host
+ * allows. It uses libdvbt2ll-core without the GNU Radio scheduler.
+ *
+ * The BBheader and BCH of every BBFRAME are added in TS order by the
+ * main thread, as they carry the TS packet position. Everything after
+ * that (LDPC, bit interleaving and mapping, frame mapping and OFDM)
+ * only depends on the T2 frame number, so every worker thread takes
+ * the next whole T2 frame with its own set of core objects. The main
+ * thread writes the frames out in order as they are done.
+ *
+ * The I/Q is written as interleaved 32 bit floats (fc32) or 16 bit
+ * integers (sc16), each sample multiplied by the scale first. The
+ * default scale is 1 for fc32 and SC16_SCALE for sc16, which puts the
+ * RMS level (about 1) at -12 dBFS and clips peaks above 12 dB.
+ *
+ * usage: dvbt2ll-encode [options] input.ts output.iq|-
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <dvbt2ll/bbframe_encoder.h>
+#include <dvbt2ll/cell_modulator.h>
+#include <dvbt2ll/frame_mapper.h>
+#include <dvbt2ll/ofdm_modulator.h>
+#include <gnuradio/thread/thread.h>
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace gr::dvbt2ll;
+
+enum iq_format_t {
+  FORMAT_FC32 = 0,
+  FORMAT_SC16,
+};
+
+/* Every block parameter, with the defaults of a 32K 256QAM 8 MHz multiplex */
+struct encode_params
+{
+  dvbt2_framesize_t framesize;
+  dvbt2_code_rate_t rate;
+  dvbt2_constellation_t constellation;
+  dvbt2_rotation_t rotation;
+  int fecblocks;
+  int tiblocks;
+  dvbt2_extended_carrier_t carriermode;
+  dvbt2_fftsize_t fftsize;
+  dvbt2_guardinterval_t guardinterval;
+  dvbt2_l1constellation_t l1constellation;
+  dvbt2_pilotpattern_t pilotpattern;
+  int t2frames;
+  int numdatasyms;
+  dvbt2_papr_t paprmode;
+  dvbt2_version_t version;
+  dvbt2_preamble_t preamble;
+  dvbt2_inputmode_t inputmode;
+  dvbt2_reservedbiasbits_t reservedbiasbits;
+  dvbt2_l1scrambled_t l1scrambled;
+  dvbt2_inband_t inband;
+  int tsrate;
+  dvbt2_misogroup_t misogroup;
+  dvbt2_equalization_t equalization;
+  dvbt2_bandwidth_t bandwidth;
+
+  encode_params()
+    : framesize(FECFRAME_NORMAL), rate(C2_3), constellation(MOD_256QAM),
+      rotation(ROTATION_ON), fecblocks(202), tiblocks(3),
+      carriermode(CARRIERS_EXTENDED), fftsize(FFTSIZE_32K),
+      guardinterval(GI_1_128), l1constellation(L1_MOD_64QAM),
+      pilotpattern(PILOT_PP7), t2frames(2), numdatasyms(59),
+      paprmode(PAPR_OFF), version(VERSION_111), preamble(PREAMBLE_T2_SISO),
+      inputmode(INPUTMODE_NORMAL), reservedbiasbits(RESERVED_OFF),
+      l1scrambled(L1_SCRAMBLED_OFF), inband(INBAND_OFF), tsrate(4000000),
+      misogroup(MISO_TX1), equalization(EQUALIZATION_OFF),
+      bandwidth(BANDWIDTH_8_0_MHZ) {}
+};
+
+struct enum_name
+{
+  const char *name;
+  int value;
+};
+
+static const enum_name framesize_names[] = {
+  {"normal", FECFRAME_NORMAL}, {"short", FECFRAME_SHORT}, {NULL, 0}};
+static const enum_name rate_names[] = {
+  {"1/2", C1_2}, {"3/5", C3_5}, {"2/3", C2_3}, {"3/4", C3_4}, {"4/5", C4_5},
+  {"5/6", C5_6}, {"1/3", C1_3}, {"2/5", C2_5}, {NULL, 0}};
+static const enum_name constellation_names[] = {
+  {"qpsk", MOD_QPSK}, {"16qam", MOD_16QAM}, {"64qam", MOD_64QAM},
+  {"256qam", MOD_256QAM}, {NULL, 0}};
+static const enum_name onoff_names[] = {
+  {"off", 0}, {"on", 1}, {NULL, 0}};
+static const enum_name carriermode_names[] = {
+  {"normal", CARRIERS_NORMAL}, {"extended", CARRIERS_EXTENDED}, {NULL, 0}};
+static const enum_name fftsize_names[] = {
+  {"1k", FFTSIZE_1K}, {"2k", FFTSIZE_2K}, {"4k", FFTSIZE_4K},
+  {"8k", FFTSIZE_8K}, {"8kt2gi", FFTSIZE_8K_T2GI}, {"16k", FFTSIZE_16K},
+  {"16kt2gi", FFTSIZE_16K_T2GI}, {"32k", FFTSIZE_32K},
+  {"32kt2gi", FFTSIZE_32K_T2GI}, {NULL, 0}};
+static const enum_name gi_names[] = {
+  {"1/32", GI_1_32}, {"1/16", GI_1_16}, {"1/8", GI_1_8}, {"1/4", GI_1_4},
+  {"1/128", GI_1_128}, {"19/128", GI_19_128}, {"19/256", GI_19_256},
+  {NULL, 0}};
+static const enum_name l1constellation_names[] = {
+  {"bpsk", L1_MOD_BPSK}, {"qpsk", L1_MOD_QPSK}, {"16qam", L1_MOD_16QAM},
+  {"64qam", L1_MOD_64QAM}, {NULL, 0}};
+static const enum_name pilot_names[] = {
+  {"pp1", PILOT_PP1}, {"pp2", PILOT_PP2}, {"pp3", PILOT_PP3},
+  {"pp4", PILOT_PP4}, {"pp5", PILOT_PP5}, {"pp6", PILOT_PP6},
+  {"pp7", PILOT_PP7}, {"pp8", PILOT_PP8}, {NULL, 0}};
+static const enum_name papr_names[] = {
+  {"off", PAPR_OFF}, {"ace", PAPR_ACE}, {"tr", PAPR_TR},
+  {"both", PAPR_BOTH}, {NULL, 0}};
+static const enum_name version_names[] = {
+  {"1.1.1", VERSION_111}, {"1.2.1", VERSION_121}, {"1.3.1", VERSION_131},
+  {NULL, 0}};
+static const enum_name preamble_names[] = {
+  {"siso", PREAMBLE_T2_SISO}, {"miso", PREAMBLE_T2_MISO},
+  {"lite-siso", PREAMBLE_T2_LITE_SISO}, {"lite-miso", PREAMBLE_T2_LITE_MISO},
+  {NULL, 0}};
+static const enum_name inputmode_names[] = {
+  {"normal", INPUTMODE_NORMAL}, {"hieff", INPUTMODE_HIEFF}, {NULL, 0}};
+static const enum_name misogroup_names[] = {
+  {"1", MISO_TX1}, {"2", MISO_TX2}, {NULL, 0}};
+static const enum_name bandwidth_names[] = {
+  {"1.7", BANDWIDTH_1_7_MHZ}, {"5", BANDWIDTH_5_0_MHZ},
+  {"6", BANDWIDTH_6_0_MHZ}, {"7", BANDWIDTH_7_0_MHZ},
+  {"8", BANDWIDTH_8_0_MHZ}, {"10", BANDWIDTH_10_0_MHZ}, {NULL, 0}};
+static const enum_name format_names[] = {
+  {"fc32", FORMAT_FC32}, {"sc16", FORMAT_SC16}, {NULL, 0}};
+
+/* Elementary period of each bandwidth in seconds */
+static const double sample_period[6] = {
+  71.0 / 131e6, 7.0 / 40e6, 7.0 / 48e6, 1.0 / 8e6, 7.0 / 64e6, 7.0 / 80e6};
+
+static bool
+parse_enum(const char *arg, const enum_name *names, int &value)
+{
+  for (int i = 0; names[i].name != NULL; i++) {
+    if (strcasecmp(arg, names[i].name) == 0) {
+      value = names[i].value;
+      return true;
+    }
+  }
+  return false;
+}
+
+static std::string
+enum_list(const enum_name *names)
+{
+  std::string list;
+
+  for (int i = 0; names[i].name != NULL; i++) {
+    if (i != 0) {
+      list += "|";
+    }
+    list += names[i].name;
+  }
+  return list;
+}
+
+static int
+fft_length(dvbt2_fftsize_t fftsize)
+{
+  switch (fftsize) {
+    case FFTSIZE_1K:
+      return 1024;
+    case FFTSIZE_2K:
+      return 2048;
+    case FFTSIZE_4K:
+      return 4096;
+    case FFTSIZE_8K:
+    case FFTSIZE_8K_T2GI:
+      return 8192;
+    case FFTSIZE_16K:
+    case FFTSIZE_16K_T2GI:
+      return 16384;
+    default:
+      return 32768;
+  }
+}
+
+/*
+ * One T2 frame on its way through the encoder. The main thread fills
+ * bits with BBFRAMEs (BBheader and BCH only), a worker turns them
+ * into the I/Q of the frame, which the main thread writes out.
+ */
+enum slot_state_t {
+  SLOT_FREE = 0,
+  SLOT_ENCODED,
+  SLOT_DONE,
+};
+
+struct frame_slot
+{
+  slot_state_t state;
+  std::vector<unsigned char> bits;
+  std::vector<gr_complex> iq;
+  int bytes;
+};
+
+/* The core objects of one worker, for everything after the BCH */
+struct frame_worker
+{
+  bbframe_encoder::sptr encoder;
+  cell_modulator::sptr modulator;
+  frame_mapper::sptr mapper;
+  ofdm_modulator::sptr ofdm;
+  std::vector<gr_complex> cells;
+  std::vector<gr_complex> mapped;
+  uint64_t next_frame;
+};
+
+class frame_encoder
+{
+ private:
+  encode_params p;
+  iq_format_t format;
+  float scale;
+  bbframe_encoder::sptr encoder;
+  std::vector<frame_worker> workers;
+  std::vector<frame_slot> slots;
+  int frame_bits;
+  int t2_frames;
+  gr::thread::mutex mutex;
+  gr::thread::condition_variable cond;
+  uint64_t next_encode;
+  uint64_t next_dispatch;
+  bool stopping;
+  boost::thread_group threads;
+
+  void
+  make_worker(frame_worker &w)
+  {
+    w.encoder = bbframe_encoder::make(p.framesize, p.rate, p.inputmode, p.inband, p.fecblocks, p.tsrate);
+    w.modulator = cell_modulator::make(p.framesize, p.rate, p.constellation, p.rotation);
+    w.mapper = frame_mapper::make(p.framesize, p.rate, p.constellation, p.rotation, p.fecblocks, p.tiblocks, p.carriermode, p.fftsize, p.guardinterval, p.l1constellation, p.pilotpattern, p.t2frames, p.numdatasyms, p.paprmode, p.version, p.preamble, p.inputmode, p.reservedbiasbits, p.l1scrambled, p.inband);
+    w.ofdm = ofdm_modulator::make(p.carriermode, p.fftsize, p.pilotpattern, p.guardinterval, p.numdatasyms, p.paprmode, p.version, p.preamble, p.misogroup, p.equalization, p.bandwidth, fft_length(p.fftsize));
+    w.cells.resize(p.fecblocks * w.modulator->output_items());
+    w.mapped.resize(w.mapper->output_items());
+    w.next_frame = 0;
+  }
+
+  /* Converts the I/Q of a frame in place, sc16 takes half the room */
+  void
+  convert(frame_slot &s)
+  {
+    int samples = s.iq.size();
+
+    if (format == FORMAT_FC32) {
+      if (scale != 1.0f) {
+        for (int i = 0; i < samples; i++) {
+          s.iq[i] *= scale;
+        }
+      }
+      s.bytes = samples * sizeof(gr_complex);
+    }
+    else {
+      int16_t *out = (int16_t *)&s.iq[0];
+      for (int i = 0; i < samples; i++) {
+        gr_complex x = s.iq[i] * scale;
+        float re = std::min(std::max(x.real(), -32767.0f), 32767.0f);
+        float im = std::min(std::max(x.imag(), -32767.0f), 32767.0f);
+        out[2 * i] = (int16_t)lrintf(re);
+        out[2 * i + 1] = (int16_t)lrintf(im);
+      }
+      s.bytes = samples * 2 * sizeof(int16_t);
+    }
+  }
+
+  /* LDPC, mapping and OFDM of T2 frame number frame */
+  void
+  process_frame(frame_worker &w, frame_slot &s, uint64_t frame)
+  {
+    for (int b = 0; b < p.fecblocks; b++) {
+      w.encoder->ldpc_encode(&s.bits[b * frame_bits]);
+    }
+    w.modulator->process(&s.bits[0], &w.cells[0], p.fecblocks);
+    w.mapper->skip_frames((frame - w.next_frame) % t2_frames);
+    w.mapper->process(&w.cells[0], &w.mapped[0], 1);
+    w.next_frame = frame + 1;
+    w.ofdm->process(&w.mapped[0], &s.iq[0], 1);
+    convert(s);
+  }
+
+  void
+  worker_thread(frame_worker *w)
+  {
+    uint64_t frame;
+
+    for (;;) {
+      {
+        gr::thread::scoped_lock lock(mutex);
+        while (!stopping && next_dispatch == next_encode) {
+          cond.wait(lock);
+        }
+        if (next_dispatch == next_encode) {
+          return;
+        }
+        frame = next_dispatch++;
+      }
+      frame_slot &s = slots[frame % slots.size()];
+      process_frame(*w, s, frame);
+      {
+        gr::thread::scoped_lock lock(mutex);
+        s.state = SLOT_DONE;
+      }
+      cond.notify_all();
+    }
+  }
+
+ public:
+  frame_encoder(const encode_params &params, iq_format_t fmt, float sc, int nthreads)
+    : p(params), format(fmt), scale(sc), next_encode(0), next_dispatch(0),
+      stopping(false)
+  {
+    encoder = bbframe_encoder::make(p.framesize, p.rate, p.inputmode, p.inband, p.fecblocks, p.tsrate);
+    frame_bits = encoder->frame_bits();
+    t2_frames = p.t2frames;
+    workers.resize(std::max(nthreads, 1));
+    for (size_t i = 0; i < workers.size(); i++) {
+      make_worker(workers[i]);
+    }
+    /* one frame being encoded and one being written on top of the workers */
+    slots.resize(nthreads + 2);
+    for (size_t i = 0; i < slots.size(); i++) {
+      slots[i].state = SLOT_FREE;
+      slots[i].bits.resize(p.fecblocks * frame_bits);
+      slots[i].iq.resize(workers[0].ofdm->output_items());
+    }
+    for (int i = 0; i < nthreads; i++) {
+      threads.create_thread(boost::bind(&frame_encoder::worker_thread, this, &workers[i]));
+    }
+  }
+
+  ~frame_encoder()
+  {
+    {
+      gr::thread::scoped_lock lock(mutex);
+      stopping = true;
+    }
+    cond.notify_all();
+    threads.join_all();
+  }
+
+  bool fits() const { return workers[0].mapper->fits(); }
+  int frame_items() const { return workers[0].ofdm->output_items(); }
+  uint64_t sync_errors() const { return encoder->sync_errors(); }
+
+  /* TS bytes the next T2 frame takes */
+  int input_items() const { return encoder->input_items(p.fecblocks); }
+
+  /* True if there is a free slot for the next frame */
+  bool
+  can_encode(uint64_t next_write)
+  {
+    return next_encode - next_write < slots.size();
+  }
+
+  /* Adds the BBheaders and BCH of the next T2 frame, returns the TS bytes used */
+  int
+  encode(const unsigned char *in)
+  {
+    frame_slot &s = slots[next_encode % slots.size()];
+    int consumed = 0;
+
+    for (int b = 0; b < p.fecblocks; b++) {
+      consumed += encoder->encode_frame(&in[consumed], &s.bits[b * frame_bits]);
+    }
+    {
+      gr::thread::scoped_lock lock(mutex);
+      s.state = SLOT_ENCODED;
+      next_encode++;
+    }
+    cond.notify_all();
+    return consumed;
+  }
+
+  uint64_t encoded() const { return next_encode; }
+
+  /* Waits for T2 frame number frame, done in this thread without workers */
+  frame_slot &
+  wait(uint64_t frame)
+  {
+    frame_slot &s = slots[frame % slots.size()];
+
+    if (threads.size() == 0) {
+      next_dispatch++;
+      process_frame(workers[0], s, frame);
+      s.state = SLOT_DONE;
+    }
+    else {
+      gr::thread::scoped_lock lock(mutex);
+      while (s.state != SLOT_DONE) {
+        cond.wait(lock);
+      }
+    }
+    return s;
+  }
+
+  void
+  release(frame_slot &s)
+  {
+    gr::thread::scoped_lock lock(mutex);
+    s.state = SLOT_FREE;
+  }
+};
+
+static void
+usage(const char *name)
+{
+  fprintf(stderr, "usage: %s [options] input.ts output.iq|-\n", name);
+  fprintf(stderr, "  --framesize %s\n", enum_list(framesize_names).c_str());
+  fprintf(stderr, "  --rate %s\n", enum_list(rate_names).c_str());
+  fprintf(stderr, "  --constellation %s\n", enum_list(constellation_names).c_str());
+  fprintf(stderr, "  --rotation off|on\n");
+  fprintf(stderr, "  --fecblocks N  --tiblocks N  --t2frames N  --numdatasyms N\n");
+  fprintf(stderr, "  --carriermode %s\n", enum_list(carriermode_names).c_str());
+  fprintf(stderr, "  --fftsize %s\n", enum_list(fftsize_names).c_str());
+  fprintf(stderr, "  --guardinterval %s\n", enum_list(gi_names).c_str());
+  fprintf(stderr, "  --l1constellation %s\n", enum_list(l1constellation_names).c_str());
+  fprintf(stderr, "  --pilotpattern %s\n", enum_list(pilot_names).c_str());
+  fprintf(stderr, "  --paprmode %s\n", enum_list(papr_names).c_str());
+  fprintf(stderr, "  --version %s\n", enum_list(version_names).c_str());
+  fprintf(stderr, "  --preamble %s\n", enum_list(preamble_names).c_str());
+  fprintf(stderr, "  --inputmode %s\n", enum_list(inputmode_names).c_str());
+  fprintf(stderr, "  --reservedbiasbits off|on  --l1scrambled off|on  --inband off|on\n");
+  fprintf(stderr, "  --tsrate bps\n");
+  fprintf(stderr, "  --misogroup %s\n", enum_list(misogroup_names).c_str());
+  fprintf(stderr, "  --equalization off|on\n");
+  fprintf(stderr, "  --bandwidth %s\n", enum_list(bandwidth_names).c_str());
+  fprintf(stderr, "  --format %s  --scale X (default 1 for fc32, 8192 for sc16)\n", enum_list(format_names).c_str());
+  fprintf(stderr, "  --threads N (0 encodes in the main thread)  --frames N\n");
+}
+
+int
+main(int argc, char **argv)
+{
+  encode_params p;
+  int format = FORMAT_FC32;
+  float scale = 0.0f;
+  int nthreads = boost::thread::hardware_concurrency();
+  long max_frames = 0;
+  std::vector<const char *> files;
+
+  for (int i = 1; i < argc; i++) {
+    const char *opt = argv[i];
+    const char *arg = (i + 1 < argc) ? argv[i + 1] : NULL;
+    int value;
+    bool ok = true;
+
+    if (strncmp(opt, "--", 2) != 0 || strlen(opt) == 2) {
+      files.push_back(opt);
+      continue;
+    }
+    if (arg == NULL) {
+      usage(argv[0]);
+      return 1;
+    }
+    i++;
+    opt += 2;
+#define ENUM_OPTION(key, field, names, type) \
+    else if (strcmp(opt, key) == 0) { \
+      if ((ok = parse_enum(arg, names, value))) { \
+        p.field = (type)value; \
+      } \
+    }
+    if (strcmp(opt, "fecblocks") == 0) {
+      p.fecblocks = atoi(arg);
+    }
+    ENUM_OPTION("framesize", framesize, framesize_names, dvbt2_framesize_t)
+    ENUM_OPTION("rate", rate, rate_names, dvbt2_code_rate_t)
+    ENUM_OPTION("constellation", constellation, constellation_names, dvbt2_constellation_t)
+    ENUM_OPTION("rotation", rotation, onoff_names, dvbt2_rotation_t)
+    ENUM_OPTION("carriermode", carriermode, carriermode_names, dvbt2_extended_carrier_t)
+    ENUM_OPTION("fftsize", fftsize, fftsize_names, dvbt2_fftsize_t)
+    ENUM_OPTION("guardinterval", guardinterval, gi_names, dvbt2_guardinterval_t)
+    ENUM_OPTION("l1constellation", l1constellation, l1constellation_names, dvbt2_l1constellation_t)
+    ENUM_OPTION("pilotpattern", pilotpattern, pilot_names, dvbt2_pilotpattern_t)
+    ENUM_OPTION("paprmode", paprmode, papr_names, dvbt2_papr_t)
+    ENUM_OPTION("version", version, version_names, dvbt2_version_t)
+    ENUM_OPTION("preamble", preamble, preamble_names, dvbt2_preamble_t)
+    ENUM_OPTION("inputmode", inputmode, inputmode_names, dvbt2_inputmode_t)
+    ENUM_OPTION("reservedbiasbits", reservedbiasbits, onoff_names, dvbt2_reservedbiasbits_t)
+    ENUM_OPTION("l1scrambled", l1scrambled, onoff_names, dvbt2_l1scrambled_t)
+    ENUM_OPTION("inband", inband, onoff_names, dvbt2_inband_t)
+    ENUM_OPTION("misogroup", misogroup, misogroup_names, dvbt2_misogroup_t)
+    ENUM_OPTION("equalization", equalization, onoff_names, dvbt2_equalization_t)
+    ENUM_OPTION("bandwidth", bandwidth, bandwidth_names, dvbt2_bandwidth_t)
+#undef ENUM_OPTION
+    else if (strcmp(opt, "tiblocks") == 0) {
+      p.tiblocks = atoi(arg);
+    }
+    else if (strcmp(opt, "t2frames") == 0) {
+      p.t2frames = atoi(arg);
+    }
+    else if (strcmp(opt, "numdatasyms") == 0) {
+      p.numdatasyms = atoi(arg);
+    }
+    else if (strcmp(opt, "tsrate") == 0) {
+      p.tsrate = atoi(arg);
+    }
+    else if (strcmp(opt, "format") == 0) {
+      ok = parse_enum(arg, format_names, format);
+    }
+    else if (strcmp(opt, "scale") == 0) {
+      scale = atof(arg);
+    }
+    else if (strcmp(opt, "threads") == 0) {
+      nthreads = atoi(arg);
+    }
+    else if (strcmp(opt, "frames") == 0) {
+      max_frames = atol(arg);
+    }
+    else {
+      ok = false;
+    }
+    if (!ok) {
+      fprintf(stderr, "bad option --%s %s\n", opt, arg);
+      usage(argv[0]);
+      return 1;
+    }
+  }
+  if (files.size() != 2 || p.fecblocks < 1 || p.tiblocks < 1 || p.t2frames < 1 || p.numdatasyms < 1 || nthreads < 0) {
+    usage(argv[0]);
+    return 1;
+  }
+
+  if (scale == 0.0f) {
+    scale = (format == FORMAT_SC16) ? SC16_SCALE : 1.0f;
+  }
+
+  int fd = open(files[0], O_RDONLY);
+  struct stat st;
+  if (fd < 0 || fstat(fd, &st) != 0) {
+    fprintf(stderr, "cannot open %s\n", files[0]);
+    return 1;
+  }
+  size_t ts_size = st.st_size;
+  const unsigned char *ts = NULL;
+  if (ts_size > 0) {
+    ts = (const unsigned char *)mmap(NULL, ts_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (ts == MAP_FAILED) {
+      fprintf(stderr, "cannot map %s\n", files[0]);
+      return 1;
+    }
+    posix_madvise((void *)ts, ts_size, POSIX_MADV_SEQUENTIAL);
+  }
+
+  FILE *out = stdout;
+  if (strcmp(files[1], "-") != 0) {
+    out = fopen(files[1], "wb");
+    if (out == NULL) {
+      fprintf(stderr, "cannot open %s\n", files[1]);
+      return 1;
+    }
+  }
+
+  frame_encoder enc(p, (iq_format_t)format, scale, nthreads);
+  if (!enc.fits()) {
+    fprintf(stderr, "the FEC blocks don't fit in the data symbols\n");
+    return 1;
+  }
+
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  size_t pos = 0;
+  uint64_t written = 0;
+  bool end = false;
+  for (;;) {
+    while (!end && enc.can_encode(written)) {
+      if ((max_frames > 0 && enc.encoded() == (uint64_t)max_frames) || pos + enc.input_items() > ts_size) {
+        end = true;
+        break;
+      }
+      pos += enc.encode(&ts[pos]);
+    }
+    if (written == enc.encoded()) {
+      break;
+    }
+    frame_slot &s = enc.wait(written);
+    if (fwrite(&s.iq[0], 1, s.bytes, out) != (size_t)s.bytes) {
+      fprintf(stderr, "write error on %s\n", files[1]);
+      return 1;
+    }
+    enc.release(s);
+    written++;
+  }
+  double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  double signal = (double)written * enc.frame_items() * sample_period[p.bandwidth];
+
+  if (out != stdout) {
+    fclose(out);
+  }
+  if (ts_size > 0) {
+    munmap((void *)ts, ts_size);
+  }
+  close(fd);
+  fprintf(stderr, "%llu T2 frames, %llu of %zu TS bytes, %.3f s of signal in %.3f s (%.1fx real time), %llu TS sync errors\n",
+          (unsigned long long)written, (unsigned long long)pos, ts_size, signal, wall,
+          wall > 0.0 ? signal / wall : 0.0, (unsigned long long)enc.sync_errors());
+  return 0;
+}
@@ -24,7 +24,20 @@ FIND_LIBRARY(
           /usr/lib64
 )
 
+FIND_LIBRARY(
+    DVBT2LL_CORE_LIBRARIES
+    NAMES dvbt2ll-core
+    HINTS $ENV{DVBT2LL_DIR}/lib
+        ${PC_DVBT2LL_LIBDIR}
+    PATHS ${CMAKE_INSTALL_PREFIX}/lib
+          ${CMAKE_INSTALL_PREFIX}/lib64
+          /usr/local/lib
+          /usr/local/lib64
+          /usr/lib
+          /usr/lib64
+)
+
 INCLUDE(FindPackageHandleStandardArgs)
 FIND_PACKAGE_HANDLE_STANDARD_ARGS(DVBT2LL DEFAULT_MSG DVBT2LL_LIBRARIES DVBT2LL_INCLUDE_DIRS)
-MARK_AS_ADVANCED(DVBT2LL_LIBRARIES DVBT2LL_INCLUDE_DIRS)
+MARK_AS_ADVANCED(DVBT2LL_LIBRARIES DVBT2LL_CORE_LIBRARIES DVBT2LL_INCLUDE_DIRS)
 
@@ -30,4 +30,10 @@
 #  define DVBT2LL_API __GR_ATTR_IMPORT
 #endif
 
+#ifdef dvbt2ll_core_EXPORTS
+#  define DVBT2LL_CORE_API __GR_ATTR_EXPORT
+#else
+#  define DVBT2LL_CORE_API __GR_ATTR_IMPORT
+#endif
+
 #endif /* INCLUDED_DVBT2LL_API_H */
@@ -0,0 +1,77 @@
+/* -*- c++ -*- */
+/* 
+ * Copyright 2017 Ron Economos.
+ * 
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ * 
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_DVBT2LL_BBFRAME_ENCODER_H
+#define INCLUDED_DVBT2LL_BBFRAME_ENCODER_H
+
+#include <dvbt2ll/api.h>
+#include <dvbt2ll/dvbt2ll_config.h>
+#include <boost/shared_ptr.hpp>
+#include <stdint.h>
+
+namespace gr {
+  namespace dvbt2ll {
+
+    /*!
+     * \brief BBframe encoder of libdvbt2ll-core: TS packets to
+     * BBFRAMEs with BBheader, BCH and LDPC parity, one bit per byte.
+     * \ingroup dvbt2ll
+     *
+     * Plain C++, without the GNU Radio scheduler. The TS packet
+     * position and the in-band signalling state are kept from one
+     * call to the next, so the input has to be passed in stream
+     * order. bbheaderbch_bb is a wrapper around it.
+     */
+    class DVBT2LL_CORE_API bbframe_encoder
+    {
+     public:
+      typedef boost::shared_ptr<bbframe_encoder> sptr;
+
+      static sptr make(dvbt2_framesize_t framesize, dvbt2_code_rate_t rate, dvbt2_inputmode_t mode, dvbt2_inband_t inband, int fecblocks, int tsrate);
+      virtual ~bbframe_encoder() {}
+
+      /* Bits of a BBFRAME with BCH parity (Nbch) and of an FEC block (Nldpc) */
+      virtual int bch_bits() const = 0;
+      virtual int frame_bits() const = 0;
+
+      /* TS bytes the next blocks FEC blocks take */
+      virtual int input_items(int blocks) const = 0;
+
+      /*!
+       * Encodes blocks FEC blocks of frame_bits() each from the TS at
+       * in, which must hold input_items(blocks) bytes. Returns the
+       * number of TS bytes used.
+       */
+      virtual int process(const unsigned char *in, unsigned char *out, int blocks) = 0;
+
+      /* One BBFRAME of bch_bits() without the LDPC parity, returns the TS bytes used */
+      virtual int encode_frame(const unsigned char *in, unsigned char *out) = 0;
+
+      /* Adds the LDPC parity to a BBFRAME from encode_frame() */
+      virtual void ldpc_encode(unsigned char *frame) = 0;
+
+      /* TS packets that didn't start with 0x47 so far */
+      virtual uint64_t sync_errors() const = 0;
+    };
+
+  } // namespace dvbt2ll
+} // namespace gr
+
+#endif /* INCLUDED_DVBT2LL_BBFRAME_ENCODER_H */
@@ -45,8 +45,13 @@ namespace gr {
        * constructor is in a private implementation
        * class. dvbt2ll::bbheaderbch_bb::make is the public interface for
        * creating new instances.
+       *
+       * With latency set to LATENCY_ON, the first bit of every BBFRAME
+       * gets a "ts_time" stream tag with the time its first TS byte
+       * arrived. The other blocks carry it to the T2 frame and
+       * pilotgenp1insert_cc publishes the TS to I/Q latency.
        */
-      static sptr make(dvbt2_framesize_t framesize, dvbt2_code_rate_t rate, dvbt2_inputmode_t mode, dvbt2_inband_t inband, int fecblocks, int tsrate);
+      static sptr make(dvbt2_framesize_t framesize, dvbt2_code_rate_t rate, dvbt2_inputmode_t mode, dvbt2_inband_t inband, int fecblocks, int tsrate, dvbt2_latency_t latency = LATENCY_OFF);
     };
 
   } // namespace dvbt2ll
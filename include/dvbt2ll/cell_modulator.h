@@ -0,0 +1,68 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2017 Ron Economos.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_DVBT2LL_CELL_MODULATOR_H
+#define INCLUDED_DVBT2LL_CELL_MODULATOR_H
+
+#include <dvbt2ll/api.h>
+#include <dvbt2ll/dvbt2ll_config.h>
+#include <gnuradio/gr_complex.h>
+#include <volk/volk_complex.h>
+#include <boost/shared_ptr.hpp>
+
+namespace gr {
+  namespace dvbt2ll {
+
+    /*!
+     * \brief Cell modulator of libdvbt2ll-core: bit interleaving and
+     * constellation mapping of FEC blocks.
+     * \ingroup dvbt2ll
+     *
+     * Plain C++, without the GNU Radio scheduler. FEC blocks are
+     * independent, so one instance per thread can work on different
+     * blocks of the same stream. interleavermod_bc is a wrapper
+     * around it.
+     */
+    class DVBT2LL_CORE_API cell_modulator
+    {
+     public:
+      typedef boost::shared_ptr<cell_modulator> sptr;
+
+      static sptr make(dvbt2_framesize_t framesize, dvbt2_code_rate_t rate, dvbt2_constellation_t constellation, dvbt2_rotation_t rotation);
+      virtual ~cell_modulator() {}
+
+      /* Bits in and cells out per FEC block */
+      virtual int input_items() const = 0;
+      virtual int output_items() const = 0;
+
+      /* Maps blocks FEC blocks from in to out, returns the bits used */
+      virtual int process(const unsigned char *in, gr_complex *out, int blocks) = 0;
+
+      /* The same with Q2.13 cells (CELL_SC16_SCALE is 1.0) */
+      virtual int process(const unsigned char *in, lv_16sc_t *out, int blocks) = 0;
+
+      /* Takes effect with the next FEC block, output_items() changes with it */
+      virtual void set_constellation(dvbt2_constellation_t constellation, dvbt2_rotation_t rotation) = 0;
+    };
+
+  } // namespace dvbt2ll
+} // namespace gr
+
+#endif /* INCLUDED_DVBT2LL_CELL_MODULATOR_H */
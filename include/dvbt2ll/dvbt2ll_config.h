@@ -47,14 +47,17 @@
 #define FRAME_SIZE_NORMAL 64800
 #define FRAME_SIZE_SHORT  16200
 
+/* sc16 cells are Q2.13, the largest rotated 256QAM component is 1.63 */
+#define CELL_SC16_SCALE 8192.0f
+/* sc16 I/Q: the RMS level (about 1) at -12 dBFS, peaks above 12 dB clip */
+#define SC16_SCALE 8192.0f
+
 // BCH Code
 #define BCH_CODE_N8  0
 #define BCH_CODE_N10 1
 #define BCH_CODE_N12 2
 #define BCH_CODE_S12 3
 
-#define LDPC_ENCODE_TABLE_LENGTH (FRAME_SIZE_NORMAL * 10)
-
 namespace gr {
   namespace dvbt2ll {
     enum dvbt2_code_rate_t {
@@ -175,6 +178,7 @@ namespace gr {
     enum dvbt2_misogroup_t {
       MISO_TX1 = 0,
       MISO_TX2,
+      MISO_TX1_TX2,
     };
 
     enum dvbt2_showlevels_t {
@@ -201,6 +205,21 @@ namespace gr {
       BANDWIDTH_10_0_MHZ,
     };
 
+    enum dvbt2_pipeline_t {
+      PIPELINE_OFF = 0,
+      PIPELINE_ON,
+    };
+
+    enum dvbt2_latency_t {
+      LATENCY_OFF = 0,
+      LATENCY_ON,
+    };
+
+    enum dvbt2_cellformat_t {
+      CELLFORMAT_FLOAT = 0,
+      CELLFORMAT_SC16,
+    };
+
   } // namespace dvbt2ll
 } // namespace gr
 
@@ -225,6 +244,9 @@ typedef gr::dvbt2ll::dvbt2_showlevels_t dvbt2_showlevels_t;
 typedef gr::dvbt2ll::dvbt2_inband_t dvbt2_inband_t;
 typedef gr::dvbt2ll::dvbt2_equalization_t dvbt2_equalization_t;
 typedef gr::dvbt2ll::dvbt2_bandwidth_t dvbt2_bandwidth_t;
+typedef gr::dvbt2ll::dvbt2_pipeline_t dvbt2_pipeline_t;
+typedef gr::dvbt2ll::dvbt2_latency_t dvbt2_latency_t;
+typedef gr::dvbt2ll::dvbt2_cellformat_t dvbt2_cellformat_t;
 
 #endif /* INCLUDED_DVBT2LL_CONFIG_H */
 
@@ -0,0 +1,78 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2017 Ron Economos.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_DVBT2LL_FRAME_MAPPER_H
+#define INCLUDED_DVBT2LL_FRAME_MAPPER_H
+
+#include <dvbt2ll/api.h>
+#include <dvbt2ll/dvbt2ll_config.h>
+#include <gnuradio/gr_complex.h>
+#include <volk/volk_complex.h>
+#include <boost/shared_ptr.hpp>
+
+namespace gr {
+  namespace dvbt2ll {
+
+    /*!
+     * \brief Frame mapper of libdvbt2ll-core: cell and time
+     * interleaving, L1 signalling, frame building and frequency
+     * interleaving of whole T2 frames.
+     * \ingroup dvbt2ll
+     *
+     * Plain C++, without the GNU Radio scheduler. The T2 frame number
+     * in the super-frame is kept from one call to the next.
+     * framemapperfint_cc is a wrapper around it, which adds the
+     * run time configuration changes, streaming and the pipelined
+     * mapping.
+     */
+    class DVBT2LL_CORE_API frame_mapper
+    {
+     public:
+      typedef boost::shared_ptr<frame_mapper> sptr;
+
+      static sptr make(dvbt2_framesize_t framesize, dvbt2_code_rate_t rate, dvbt2_constellation_t constellation, dvbt2_rotation_t rotation, int fecblocks, int tiblocks, dvbt2_extended_carrier_t carriermode, dvbt2_fftsize_t fftsize, dvbt2_guardinterval_t guardinterval, dvbt2_l1constellation_t l1constellation, dvbt2_pilotpattern_t pilotpattern, int t2frames, int numdatasyms, dvbt2_papr_t paprmode, dvbt2_version_t version, dvbt2_preamble_t preamble, dvbt2_inputmode_t inputmode, dvbt2_reservedbiasbits_t reservedbiasbits, dvbt2_l1scrambled_t l1scrambled, dvbt2_inband_t inband);
+      virtual ~frame_mapper() {}
+
+      /* Cells in (FEC blocks times cells per block) and out per T2 frame */
+      virtual int input_items() const = 0;
+      virtual int output_items() const = 0;
+
+      /* False if the FEC blocks don't fit in the data symbols */
+      virtual bool fits() const = 0;
+
+      /* Maps frames T2 frames from in to out, returns the cells used */
+      virtual int process(const gr_complex *in, gr_complex *out, int frames) = 0;
+
+      /* The same with Q2.13 cells, moving half the bytes */
+      virtual int process(const lv_16sc_t *in, lv_16sc_t *out, int frames) = 0;
+
+      /*!
+       * T2 frame number in the super-frame of the next frame, and
+       * skipping frames frames, so that several instances can each
+       * map a share of the frames of one stream.
+       */
+      virtual int t2_frame() const = 0;
+      virtual void skip_frames(int frames) = 0;
+    };
+
+  } // namespace dvbt2ll
+} // namespace gr
+
+#endif /* INCLUDED_DVBT2LL_FRAME_MAPPER_H */
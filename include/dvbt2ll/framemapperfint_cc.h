@@ -46,7 +46,21 @@ namespace gr {
        * class. dvbt2ll::framemapperfint_cc::make is the public interface for
        * creating new instances.
        */
-      static sptr make(dvbt2_framesize_t framesize, dvbt2_code_rate_t rate, dvbt2_constellation_t constellation, dvbt2_rotation_t rotation, int fecblocks, int tiblocks, dvbt2_extended_carrier_t carriermode, dvbt2_fftsize_t fftsize, dvbt2_guardinterval_t guardinterval, dvbt2_l1constellation_t l1constellation, dvbt2_pilotpattern_t pilotpattern, int t2frames, int numdatasyms, dvbt2_papr_t paprmode, dvbt2_version_t version, dvbt2_preamble_t preamble, dvbt2_inputmode_t inputmode, dvbt2_reservedbiasbits_t reservedbiasbits, dvbt2_l1scrambled_t l1scrambled, dvbt2_inband_t inband);
+      static sptr make(dvbt2_framesize_t framesize, dvbt2_code_rate_t rate, dvbt2_constellation_t constellation, dvbt2_rotation_t rotation, int fecblocks, int tiblocks, dvbt2_extended_carrier_t carriermode, dvbt2_fftsize_t fftsize, dvbt2_guardinterval_t guardinterval, dvbt2_l1constellation_t l1constellation, dvbt2_pilotpattern_t pilotpattern, int t2frames, int numdatasyms, dvbt2_papr_t paprmode, dvbt2_version_t version, dvbt2_preamble_t preamble, dvbt2_inputmode_t inputmode, dvbt2_reservedbiasbits_t reservedbiasbits, dvbt2_l1scrambled_t l1scrambled, dvbt2_inband_t inband, int streamsymbols = 0, int maxframes = 1, dvbt2_pipeline_t pipeline = PIPELINE_OFF, dvbt2_cellformat_t cellformat = CELLFORMAT_FLOAT);
+
+      /*!
+       * \brief Stage a new PLP configuration.
+       *
+       * The tables are built in the background and the change is
+       * announced with L1_CHANGE_COUNTER, then applied at a super-frame
+       * boundary. The new constellation and rotation are sent to
+       * interleavermod_bc on the "modcod" message port, at least an
+       * input buffer ahead, and the change only takes effect where it
+       * has tagged the switch. The same keys can be sent as a PMT dict
+       * to the "config" message port. With in-band signalling the FEC
+       * blocks can't be changed, as bbheaderbch_bb isn't told.
+       */
+      virtual void set_config(dvbt2_constellation_t constellation, dvbt2_rotation_t rotation, int fecblocks, int tiblocks, dvbt2_l1constellation_t l1constellation, int t2frames) = 0;
     };
 
   } // namespace dvbt2ll
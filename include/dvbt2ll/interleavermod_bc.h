@@ -46,7 +46,7 @@ namespace gr {
        * class. dvbt2ll::interleavermod_bc::make is the public interface for
        * creating new instances.
        */
-      static sptr make(dvbt2_framesize_t framesize, dvbt2_code_rate_t rate, dvbt2_constellation_t constellation, dvbt2_rotation_t rotation);
+      static sptr make(dvbt2_framesize_t framesize, dvbt2_code_rate_t rate, dvbt2_constellation_t constellation, dvbt2_rotation_t rotation, dvbt2_cellformat_t cellformat = CELLFORMAT_FLOAT);
     };
 
   } // namespace dvbt2ll
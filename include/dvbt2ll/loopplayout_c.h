@@ -0,0 +1,68 @@
+/* -*- c++ -*- */
+/* 
+ * Copyright 2017 Ron Economos.
+ * 
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ * 
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_DVBT2LL_LOOPPLAYOUT_C_H
+#define INCLUDED_DVBT2LL_LOOPPLAYOUT_C_H
+
+#include <dvbt2ll/api.h>
+#include <dvbt2ll/dvbt2ll_config.h>
+#include <gnuradio/sync_block.h>
+#include <string>
+
+namespace gr {
+  namespace dvbt2ll {
+
+    /*!
+     * \brief Plays a TS loop as DVB-T2 I/Q from a precomputed cache.
+     * \ingroup dvbt2ll
+     *
+     * Encodes the TS in tsfile, played in a loop, once through the
+     * whole chain and then repeats the I/Q, so a carousel or test
+     * signal takes no more than a copy per sample. The I/Q is kept in
+     * cachefile, which is used again by the next run with the same
+     * parameters and TS, and rebuilt otherwise.
+     */
+    class DVBT2LL_API loopplayout_c : virtual public gr::sync_block
+    {
+     public:
+      typedef boost::shared_ptr<loopplayout_c> sptr;
+
+      /*!
+       * \brief Return a shared_ptr to a new instance of dvbt2ll::loopplayout_c.
+       *
+       * To avoid accidental use of raw pointers, dvbt2ll::loopplayout_c's
+       * constructor is in a private implementation
+       * class. dvbt2ll::loopplayout_c::make is the public interface for
+       * creating new instances.
+       *
+       * The cached I/Q is the shortest whole number of super-frames
+       * after which the TS loop starts over at the beginning of a T2
+       * frame, up to maxframes T2 frames. A loop that doesn't line up
+       * within maxframes is cut there, with a TS discontinuity at the
+       * wrap. An empty cachefile keeps the I/Q in memory only.
+       */
+      static sptr make(const std::string &tsfile, const std::string &cachefile, dvbt2_framesize_t framesize, dvbt2_code_rate_t rate, dvbt2_constellation_t constellation, dvbt2_rotation_t rotation, int fecblocks, int tiblocks, dvbt2_extended_carrier_t carriermode, dvbt2_fftsize_t fftsize, dvbt2_guardinterval_t guardinterval, dvbt2_l1constellation_t l1constellation, dvbt2_pilotpattern_t pilotpattern, int t2frames, int numdatasyms, dvbt2_papr_t paprmode, dvbt2_version_t version, dvbt2_preamble_t preamble, dvbt2_inputmode_t inputmode, dvbt2_reservedbiasbits_t reservedbiasbits, dvbt2_l1scrambled_t l1scrambled, dvbt2_inband_t inband, int tsrate, dvbt2_misogroup_t misogroup, dvbt2_equalization_t equalization, dvbt2_bandwidth_t bandwidth, int vlength, int maxframes = 200);
+    };
+
+  } // namespace dvbt2ll
+} // namespace gr
+
+#endif /* INCLUDED_DVBT2LL_LOOPPLAYOUT_C_H */
+
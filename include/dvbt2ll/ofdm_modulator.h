@@ -0,0 +1,78 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2017 Ron Economos.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_DVBT2LL_OFDM_MODULATOR_H
+#define INCLUDED_DVBT2LL_OFDM_MODULATOR_H
+
+#include <dvbt2ll/api.h>
+#include <dvbt2ll/dvbt2ll_config.h>
+#include <gnuradio/gr_complex.h>
+#include <volk/volk_complex.h>
+#include <boost/shared_ptr.hpp>
+
+namespace gr {
+  namespace dvbt2ll {
+
+    /*!
+     * \brief OFDM modulator of libdvbt2ll-core: pilot insertion, IFFT,
+     * guard interval and P1 symbol of whole T2 frames.
+     * \ingroup dvbt2ll
+     *
+     * Plain C++, without the GNU Radio scheduler. T2 frames are
+     * independent, so one instance per thread can work on different
+     * frames of the same stream. pilotgenp1insert_cc is a wrapper
+     * around it.
+     */
+    class DVBT2LL_CORE_API ofdm_modulator
+    {
+     public:
+      typedef boost::shared_ptr<ofdm_modulator> sptr;
+
+      static sptr make(dvbt2_extended_carrier_t carriermode, dvbt2_fftsize_t fftsize, dvbt2_pilotpattern_t pilotpattern, dvbt2_guardinterval_t guardinterval, int numdatasyms, dvbt2_papr_t paprmode, dvbt2_version_t version, dvbt2_preamble_t preamble, dvbt2_misogroup_t misogroup, dvbt2_equalization_t equalization, dvbt2_bandwidth_t bandwidth, int vlength);
+      virtual ~ofdm_modulator() {}
+
+      /* Cells in and samples out (P1 symbol included) per T2 frame */
+      virtual int input_items() const = 0;
+      virtual int output_items() const = 0;
+
+      /*
+       * Modulates frames T2 frames from in to out, returns the cells
+       * used. Throws std::invalid_argument with MISO_TX1_TX2.
+       */
+      virtual int process(const gr_complex *in, gr_complex *out, int frames) = 0;
+
+      /*
+       * The same from Q2.13 cells to sc16 I/Q scaled by SC16_SCALE.
+       * The IFFT itself is still in floating point.
+       */
+      virtual int process(const lv_16sc_t *in, lv_16sc_t *out, int frames) = 0;
+
+      /*
+       * With MISO_TX1_TX2, both MISO groups from one pass: Tx1 to out
+       * and Tx2, with the modified Alamouti cells, to out2.
+       */
+      virtual int process(const gr_complex *in, gr_complex *out, gr_complex *out2, int frames) = 0;
+      virtual int process(const lv_16sc_t *in, lv_16sc_t *out, lv_16sc_t *out2, int frames) = 0;
+    };
+
+  } // namespace dvbt2ll
+} // namespace gr
+
+#endif /* INCLUDED_DVBT2LL_OFDM_MODULATOR_H */
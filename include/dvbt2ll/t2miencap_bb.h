@@ -0,0 +1,70 @@
+/* -*- c++ -*- */
+/* 
+ * Copyright 2017 Ron Economos.
+ * 
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ * 
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_DVBT2LL_T2MIENCAP_BB_H
+#define INCLUDED_DVBT2LL_T2MIENCAP_BB_H
+
+#include <dvbt2ll/api.h>
+#include <dvbt2ll/dvbt2ll_config.h>
+#include <gnuradio/block.h>
+
+namespace gr {
+  namespace dvbt2ll {
+
+    /*!
+     * \brief T2-MI encapsulator (ETSI TS 102 773), BBFRAMEs in, TS out.
+     * \ingroup dvbt2ll
+     *
+     * Takes the BBFRAMEs of bbheaderbch_bb and sends every T2 frame
+     * as T2-MI packets in a TS: its BBFRAMEs, a DVB-T2 timestamp and
+     * the L1-current signalling, made the way framemapperfint_cc
+     * makes it. A T2-MI modulator at each site does the rest of the
+     * chain, and all of them put the T2 frame on air at the time in
+     * the timestamp.
+     */
+    class DVBT2LL_API t2miencap_bb : virtual public gr::block
+    {
+     public:
+      typedef boost::shared_ptr<t2miencap_bb> sptr;
+
+      /*!
+       * \brief Return a shared_ptr to a new instance of dvbt2ll::t2miencap_bb.
+       *
+       * To avoid accidental use of raw pointers, dvbt2ll::t2miencap_bb's
+       * constructor is in a private implementation
+       * class. dvbt2ll::t2miencap_bb::make is the public interface for
+       * creating new instances.
+       *
+       * The parameters up to inband must match bbheaderbch_bb and the
+       * frame mapper of the modulators. The packets go out on pid.
+       * The first T2 frame is stamped to go on air delay seconds
+       * after it was made, rounded up to a whole second, and the
+       * following ones a T2 frame apart, so the TS must come in at
+       * the real rate. utco is written to the timestamps and added to
+       * the host UTC time (the leap seconds since 2000, 5 since 2017).
+       */
+      static sptr make(dvbt2_framesize_t framesize, dvbt2_code_rate_t rate, dvbt2_constellation_t constellation, dvbt2_rotation_t rotation, int fecblocks, int tiblocks, dvbt2_extended_carrier_t carriermode, dvbt2_fftsize_t fftsize, dvbt2_guardinterval_t guardinterval, dvbt2_l1constellation_t l1constellation, dvbt2_pilotpattern_t pilotpattern, int t2frames, int numdatasyms, dvbt2_papr_t paprmode, dvbt2_version_t version, dvbt2_preamble_t preamble, dvbt2_inputmode_t inputmode, dvbt2_reservedbiasbits_t reservedbiasbits, dvbt2_l1scrambled_t l1scrambled, dvbt2_inband_t inband, dvbt2_bandwidth_t bandwidth, int pid = 4096, double delay = 1.0, int utco = 5);
+    };
+
+  } // namespace dvbt2ll
+} // namespace gr
+
+#endif /* INCLUDED_DVBT2LL_T2MIENCAP_BB_H */
+
@@ -0,0 +1,147 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2017 Ron Economos.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_DVBT2LL_BBFRAME_ENCODER_IMPL_H
+#define INCLUDED_DVBT2LL_BBFRAME_ENCODER_IMPL_H
+
+#include <dvbt2ll/bbframe_encoder.h>
+#include "dvbt2_tables.h"
+#include "table_cache.h"
+#include "cpu_dispatch.h"
+#include <boost/tuple/tuple.hpp>
+#include <boost/tuple/tuple_comparison.hpp>
+#include <bitset>
+
+#define MAX_BCH_PARITY_BITS 192
+
+typedef struct{
+    int ts_gs;
+    int sis_mis;
+    int ccm_acm;
+    int issyi;
+    int npd;
+    int ro;
+    int isi;
+    int upl;
+    int dfl;
+    int sync;
+    int syncd;
+}BBHeader;
+
+typedef struct{
+   BBHeader bb_header;
+}FrameFormat;
+
+namespace gr {
+  namespace dvbt2ll {
+
+    class DVBT2LL_CORE_API bbframe_encoder_impl : public bbframe_encoder
+    {
+     private:
+      unsigned int kbch;
+      unsigned int nbch;
+      unsigned int count;
+      unsigned char crc;
+      unsigned int input_mode;
+      unsigned int extra;
+      unsigned int frame_size;
+      unsigned int frame_size_type;
+      unsigned int q_val;
+      unsigned int code_rate;
+      int inband_type_b;
+      int fec_blocks;
+      int fec_block;
+      int ts_rate;
+      uint64_t sync_error_count;
+      FrameFormat m_format[1];
+      unsigned char crc_tab[256];
+      unsigned int bch_code;
+      unsigned int num_parity_bits;
+      const cpu_kernels *kernels;
+
+      /*
+       * BCH remainder table and LDPC parity lookup, shared by all
+       * instances with the same code.
+       */
+      struct bch_tables
+      {
+        std::bitset<MAX_BCH_PARITY_BITS> crc_table[256];
+      };
+      struct ldpc_lookup
+      {
+        int **lut;
+        ldpc_lookup() : lut(NULL) {}
+        ~ldpc_lookup() { if (lut) { delete[] lut[0]; delete[] lut; } }
+      };
+      typedef boost::tuple<int, int> ldpc_key;
+      static table_cache<int, bch_tables> bch_cache;
+      static table_cache<ldpc_key, ldpc_lookup> ldpc_cache;
+      boost::shared_ptr<const bch_tables> bch;
+      boost::shared_ptr<const ldpc_lookup> ldpc;
+
+      void calculate_crc_table(std::bitset<MAX_BCH_PARITY_BITS> *, const std::bitset<MAX_BCH_PARITY_BITS> &);
+      void add_bbheader(unsigned char *, int, int);
+      void build_crc8_table(void);
+      int add_crc8_bits(unsigned char *, int);
+      void add_inband_type_b(unsigned char *, int);
+      bch_tables *bch_poly_build_tables(void);
+      ldpc_lookup *ldpc_lookup_generate(void);
+
+      const static int ldpc_tab_1_2N[90][9];
+      const static int ldpc_tab_3_5N[108][13];
+      const static int ldpc_tab_2_3N_DVBT2[120][14];
+      const static int ldpc_tab_3_4N[135][13];
+      const static int ldpc_tab_4_5N[144][12];
+      const static int ldpc_tab_5_6N[150][14];
+
+      const static int ldpc_tab_1_3S[15][13];
+      const static int ldpc_tab_2_5S[18][13];
+      const static int ldpc_tab_1_2S[20][9];
+      const static int ldpc_tab_3_5S_DVBT2[27][13];
+      const static int ldpc_tab_2_3S[30][14];
+      const static int ldpc_tab_3_4S[33][13];
+      const static int ldpc_tab_4_5S[35][4];
+      const static int ldpc_tab_5_6S[37][14];
+
+     public:
+      bbframe_encoder_impl(dvbt2_framesize_t framesize, dvbt2_code_rate_t rate, dvbt2_inputmode_t mode, dvbt2_inband_t inband, int fecblocks, int tsrate);
+      ~bbframe_encoder_impl();
+
+      int bch_bits() const { return nbch; }
+      int frame_bits() const { return frame_size; }
+      int input_items(int blocks) const;
+      int process(const unsigned char *in, unsigned char *out, int blocks);
+      int encode_frame(const unsigned char *in, unsigned char *out);
+      void ldpc_encode(unsigned char *frame);
+      uint64_t sync_errors() const { return sync_error_count; }
+
+      /* The two halves of encode_frame(), for timing them apart */
+      int add_header(const unsigned char *, unsigned char *);
+      void bch_encode(unsigned char *);
+
+      /* What bbheaderbch_bb forecasts for output_items bits */
+      int required_input(int output_items) const;
+      int frame_input_items(unsigned int &, int &) const;
+    };
+
+  } // namespace dvbt2ll
+} // namespace gr
+
+#endif /* INCLUDED_DVBT2LL_BBFRAME_ENCODER_IMPL_H */
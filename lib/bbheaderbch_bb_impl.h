@@ -22,26 +22,10 @@
 #define INCLUDED_DVBT2LL_BBHEADERBCH_BB_IMPL_H
 
 #include <dvbt2ll/bbheaderbch_bb.h>
-
-#define MAX_BCH_PARITY_BITS 192
-
-typedef struct{
-    int ts_gs;
-    int sis_mis;
-    int ccm_acm;
-    int issyi;
-    int npd;
-    int ro;
-    int isi;
-    int upl;
-    int dfl;
-    int sync;
-    int syncd;
-}BBHeader;
-
-typedef struct{
-   BBHeader bb_header;
-}FrameFormat;
+#include "bbframe_encoder_impl.h"
+#include "perf_counters.h"
+#include <gnuradio/high_res_timer.h>
+#include <deque>
 
 namespace gr {
   namespace dvbt2ll {
@@ -49,60 +33,25 @@ namespace gr {
     class bbheaderbch_bb_impl : public bbheaderbch_bb
     {
      private:
-      unsigned int kbch;
-      unsigned int nbch;
-      unsigned int count;
-      unsigned char crc;
-      unsigned int input_mode;
-      unsigned int extra;
-      unsigned int frame_size;
-      unsigned int frame_size_type;
-      unsigned int q_val;
-      unsigned int code_rate;
-      unsigned char bsave;
-      int inband_type_b;
-      int fec_blocks;
-      int fec_block;
-      int ts_rate;
-      FrameFormat m_format[1];
-      unsigned char crc_tab[256];
-      unsigned char bb_randomise[FRAME_SIZE_NORMAL];
-      unsigned int bch_code;
-      std::bitset<MAX_BCH_PARITY_BITS> crc_table[256];
-      unsigned int num_parity_bits;
-      std::bitset<MAX_BCH_PARITY_BITS> polynome;
-      void calculate_crc_table();
-      void add_bbheader(unsigned char *, int, int);
-      void build_crc8_table(void);
-      int add_crc8_bits(unsigned char *, int);
-      void add_inband_type_b(unsigned char *, int);
-      void init_bb_randomiser(void);
-      int poly_mult(const int*, int, const int*, int, int*);
-      void bch_poly_build_tables(void);
-      void bch_calculate(unsigned char *);
-      void ldpc_calculate(unsigned char *);
-      void ldpc_lookup_generate(void);
-
-      int** ldpc_lut;
-
-      const static int ldpc_tab_1_2N[90][9];
-      const static int ldpc_tab_3_5N[108][13];
-      const static int ldpc_tab_2_3N_DVBT2[120][14];
-      const static int ldpc_tab_3_4N[135][13];
-      const static int ldpc_tab_4_5N[144][12];
-      const static int ldpc_tab_5_6N[150][14];
-
-      const static int ldpc_tab_1_3S[15][13];
-      const static int ldpc_tab_2_5S[18][13];
-      const static int ldpc_tab_1_2S[20][9];
-      const static int ldpc_tab_3_5S_DVBT2[27][13];
-      const static int ldpc_tab_2_3S[30][14];
-      const static int ldpc_tab_3_4S[33][13];
-      const static int ldpc_tab_4_5S[35][4];
-      const static int ldpc_tab_5_6S[37][14];
+      bbframe_encoder_impl encoder;
+      int nbch;
+      uint64_t logged_sync_errors;
+
+      /*
+       * For latency tagging, the first input item of every call that
+       * brought new items, with the time it was called.
+       */
+      int latency_tags;
+      std::deque<std::pair<uint64_t, gr::high_res_timer_type> > arrivals;
+      uint64_t seen_items;
+      pmt::pmt_t latency_key;
+
+      perf_counters perf;
+      int perf_header;
+      int perf_bch;
 
      public:
-      bbheaderbch_bb_impl(dvbt2_framesize_t framesize, dvbt2_code_rate_t rate, dvbt2_inputmode_t mode, dvbt2_inband_t inband, int fecblocks, int tsrate);
+      bbheaderbch_bb_impl(dvbt2_framesize_t framesize, dvbt2_code_rate_t rate, dvbt2_inputmode_t mode, dvbt2_inband_t inband, int fecblocks, int tsrate, dvbt2_latency_t latency);
       ~bbheaderbch_bb_impl();
 
       void forecast (int noutput_items, gr_vector_int &ninput_items_required);
@@ -0,0 +1,168 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2017 Ron Economos.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "bch_crc_engine.h"
+#include <string.h>
+
+namespace gr {
+  namespace dvbt2ll {
+
+    static inline unsigned int
+    pack_bits(const unsigned char *bits)
+    {
+      unsigned int byte = 0;
+
+      for (int n = 0; n < 8; n++) {
+        byte = (byte << 1) | (bits[n] & 0x1);
+      }
+      return byte;
+    }
+
+    crc32_engine::crc32_engine(uint32_t poly)
+      : crc_poly(poly)
+    {
+      uint32_t crc;
+
+      for (int b = 0; b < 256; b++) {
+        crc = b << 24;
+        for (int n = 0; n < 8; n++) {
+          crc = (crc & 0x80000000) ? (crc << 1) ^ poly : crc << 1;
+        }
+        crc_table[0][b] = crc;
+      }
+      for (int b = 0; b < 256; b++) {
+        for (int k = 1; k < 8; k++) {
+          crc = crc_table[k - 1][b];
+          crc_table[k][b] = (crc << 8) ^ crc_table[0][crc >> 24];
+        }
+      }
+    }
+
+    uint32_t
+    crc32_engine::compute(const unsigned char *bits, int length) const
+    {
+      uint32_t crc = 0xffffffff;
+      unsigned int b;
+
+      while (length >= 64) {
+        crc ^= (pack_bits(&bits[0]) << 24) | (pack_bits(&bits[8]) << 16) |
+               (pack_bits(&bits[16]) << 8) | pack_bits(&bits[24]);
+        crc = crc_table[7][crc >> 24] ^ crc_table[6][(crc >> 16) & 0xff] ^
+              crc_table[5][(crc >> 8) & 0xff] ^ crc_table[4][crc & 0xff] ^
+              crc_table[3][pack_bits(&bits[32])] ^ crc_table[2][pack_bits(&bits[40])] ^
+              crc_table[1][pack_bits(&bits[48])] ^ crc_table[0][pack_bits(&bits[56])];
+        bits += 64;
+        length -= 64;
+      }
+      while (length >= 8) {
+        crc = (crc << 8) ^ crc_table[0][(crc >> 24) ^ pack_bits(bits)];
+        bits += 8;
+        length -= 8;
+      }
+      while (length > 0) {
+        b = (*bits++ & 0x1) ^ (crc >> 31);
+        crc <<= 1;
+        if (b) {
+          crc ^= crc_poly;
+        }
+        length--;
+      }
+      return crc;
+    }
+
+    bch_engine::bch_engine()
+      : nparity(0)
+    {
+      memset(bch_table, 0, sizeof(bch_table));
+      memset(bch_poly, 0, sizeof(bch_poly));
+    }
+
+    inline void
+    bch_engine::shift_bit(uint64_t *reg, int bit) const
+    {
+      int b = bit ^ (int)(reg[0] >> 63);
+
+      reg[0] = (reg[0] << 1) | (reg[1] >> 63);
+      reg[1] = (reg[1] << 1) | (reg[2] >> 63);
+      reg[2] = reg[2] << 1;
+      if (b) {
+        reg[0] ^= bch_poly[0];
+        reg[1] ^= bch_poly[1];
+        reg[2] ^= bch_poly[2];
+      }
+    }
+
+    void
+    bch_engine::init(const unsigned char *poly, int parity_bits)
+    {
+      uint64_t reg[3];
+      int pos;
+
+      nparity = parity_bits;
+      memset(bch_poly, 0, sizeof(bch_poly));
+      /* x^k is held in bit 192 - parity_bits + k, the leading term is implied */
+      for (int k = 0; k < parity_bits; k++) {
+        if (poly[k]) {
+          pos = 192 - parity_bits + k;
+          bch_poly[2 - (pos / 64)] |= (uint64_t)1 << (pos % 64);
+        }
+      }
+      for (int b = 0; b < 256; b++) {
+        reg[0] = (uint64_t)b << 56;
+        reg[1] = 0;
+        reg[2] = 0;
+        for (int n = 0; n < 8; n++) {
+          shift_bit(reg, 0);
+        }
+        bch_table[b][0] = reg[0];
+        bch_table[b][1] = reg[1];
+        bch_table[b][2] = reg[2];
+      }
+    }
+
+    void
+    bch_engine::encode(const unsigned char *bits, int length, unsigned char *parity) const
+    {
+      uint64_t reg[3] = {0, 0, 0};
+      const uint64_t *t;
+
+      while (length >= 8) {
+        t = bch_table[(reg[0] >> 56) ^ pack_bits(bits)];
+        reg[0] = ((reg[0] << 8) | (reg[1] >> 56)) ^ t[0];
+        reg[1] = ((reg[1] << 8) | (reg[2] >> 56)) ^ t[1];
+        reg[2] = (reg[2] << 8) ^ t[2];
+        bits += 8;
+        length -= 8;
+      }
+      while (length > 0) {
+        shift_bit(reg, *bits++ & 0x1);
+        length--;
+      }
+      for (int n = 0; n < nparity; n++) {
+        parity[n] = (reg[n / 64] >> (63 - (n % 64))) & 0x1;
+      }
+    }
+
+  } // namespace dvbt2ll
+} // namespace gr
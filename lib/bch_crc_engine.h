@@ -0,0 +1,75 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2017 Ron Economos.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_DVBT2LL_BCH_CRC_ENGINE_H
+#define INCLUDED_DVBT2LL_BCH_CRC_ENGINE_H
+
+#include <stdint.h>
+
+namespace gr {
+  namespace dvbt2ll {
+
+    /*
+     * Table driven (slice-by-8) MSB first CRC-32 with an initial
+     * value of 0xffffffff and no final XOR, as used for the L1
+     * signalling and the MPEG-2 sections.
+     *
+     * Input is one bit per byte, the way the L1 fields are built.
+     */
+    class crc32_engine
+    {
+     private:
+      uint32_t crc_table[8][256];
+      uint32_t crc_poly;
+
+     public:
+      crc32_engine(uint32_t poly = 0x04C11DB7);
+
+      uint32_t compute(const unsigned char *bits, int length) const;
+    };
+
+    /*
+     * Table driven systematic BCH encoder for up to 192 parity bits.
+     * The remainder is held MSB aligned in three 64-bit words and
+     * updated a byte at a time with a 256 entry table.
+     *
+     * poly holds the generator polynomial coefficients, lowest power
+     * first, and must have parity_bits + 1 entries.
+     */
+    class bch_engine
+    {
+     private:
+      uint64_t bch_table[256][3];
+      uint64_t bch_poly[3];
+      int nparity;
+
+      inline void shift_bit(uint64_t *reg, int bit) const;
+
+     public:
+      bch_engine();
+
+      void init(const unsigned char *poly, int parity_bits);
+      void encode(const unsigned char *bits, int length, unsigned char *parity) const;
+    };
+
+  } // namespace dvbt2ll
+} // namespace gr
+
+#endif /* INCLUDED_DVBT2LL_BCH_CRC_ENGINE_H */
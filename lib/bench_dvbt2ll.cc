@@ -0,0 +1,511 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2017 Ron Economos.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Per-block microbenchmark. Each block is created with make() and its
+ * general_work() is called directly, outside the scheduler, on
+ * synthetic input. Every block is swept over the parameters it takes:
+ *
+ *   bbheaderbch_bb       frame size x code rate
+ *   interleavermod_bc    frame size x code rate x constellation
+ *   framemapperfint_cc   frame size x constellation x FFT size x pilot pattern
+ *   pilotgenp1insert_cc  FFT size x pilot pattern
+ *
+ * which covers the whole modcod matrix without timing the same block
+ * configuration twice. The first two, which run the SIMD kernels, are
+ * swept once per kernel variant the CPU runs (or only the -a one).
+ * The results are written as JSON so runs can be compared across
+ * commits and CPUs.
+ *
+ * usage: bench-dvbt2ll [-o file.json] [-t seconds] [-b block] [-a arch]
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gnuradio/block.h>
+#include <gnuradio/block_detail.h>
+#include <gnuradio/buffer.h>
+#include <dvbt2ll/bbheaderbch_bb.h>
+#include <dvbt2ll/interleavermod_bc.h>
+#include <dvbt2ll/framemapperfint_cc.h>
+#include <dvbt2ll/pilotgenp1insert_cc.h>
+#include "cpu_dispatch.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+using namespace gr::dvbt2ll;
+
+/* 8 MHz channel */
+#define SAMPLE_RATE (8.0 * 8000000.0 / 7.0)
+/* 32K, PP7, GI 1/128, 256QAM 5/6, the highest payload rate in 8 MHz */
+#define REFERENCE_RATE 50.32e6
+/* T2 frames are kept under this length, below the 250 ms limit */
+#define MAX_FRAME_LENGTH 0.24
+
+struct bench_result
+{
+  std::string block;
+  std::string arch;
+  std::string params;
+  int calls;
+  int frames;
+  double ns_per_frame;
+  double mbps;
+  double rtf;
+};
+
+static const char *framesize_names[] = {"short", "normal"};
+static const char *rate_names[] = {"1/2", "3/5", "2/3", "3/4", "4/5", "5/6", "1/3", "2/5"};
+static const char *constellation_names[] = {"QPSK", "16QAM", "64QAM", "256QAM"};
+static const char *pilot_names[] = {"PP1", "PP2", "PP3", "PP4", "PP5", "PP6", "PP7", "PP8"};
+static const char *gi_names[] = {"1/32", "1/16", "1/8", "1/4", "1/128", "19/128", "19/256"};
+
+struct fft_mode
+{
+  dvbt2_fftsize_t fftsize;
+  const char *name;
+  int vlength;
+  int n_p2;
+};
+
+static const fft_mode fft_modes[] = {
+  {FFTSIZE_1K, "1K", 1024, 16},
+  {FFTSIZE_2K, "2K", 2048, 8},
+  {FFTSIZE_4K, "4K", 4096, 4},
+  {FFTSIZE_8K, "8K", 8192, 2},
+  {FFTSIZE_16K, "16K", 16384, 1},
+  {FFTSIZE_32K, "32K", 32768, 1},
+};
+
+/*
+ * For each pilot pattern allowed with an FFT size in SISO mode, the
+ * first guard interval it may be used with.
+ */
+static const dvbt2_guardinterval_t no_gi = (dvbt2_guardinterval_t)-1;
+static const dvbt2_guardinterval_t pilot_gi[6][8] = {
+  /*  PP1     PP2     PP3     PP4       PP5      PP6      PP7       PP8 */
+  {GI_1_4, GI_1_8, GI_1_8, GI_1_16, GI_1_16, no_gi,   no_gi,    no_gi},    /* 1K */
+  {GI_1_4, GI_1_8, GI_1_8, GI_1_32, GI_1_16, no_gi,   GI_1_32,  no_gi},    /* 2K */
+  {GI_1_4, GI_1_8, GI_1_8, GI_1_32, GI_1_16, no_gi,   GI_1_32,  no_gi},    /* 4K */
+  {GI_1_4, GI_1_8, GI_1_8, GI_1_32, GI_1_16, no_gi,   GI_1_128, GI_1_8},   /* 8K */
+  {GI_1_4, GI_1_8, GI_1_8, GI_1_32, GI_1_16, GI_1_32, GI_1_128, GI_1_8},   /* 16K */
+  {no_gi,  GI_1_8, no_gi,  GI_1_32, no_gi,   GI_1_32, GI_1_128, GI_1_8},   /* 32K */
+};
+
+static int
+kbch_size(dvbt2_framesize_t framesize, dvbt2_code_rate_t rate)
+{
+  static const int normal[6] = {32208, 38688, 43040, 48408, 51648, 53840};
+  static const int shortf[8] = {7032, 9552, 10632, 11712, 12432, 13152, 5232, 6312};
+
+  if (framesize == FECFRAME_NORMAL) {
+    return rate <= C5_6 ? normal[rate] : 0;
+  }
+  return shortf[rate];
+}
+
+static int
+guard_length(int vlength, dvbt2_guardinterval_t gi)
+{
+  switch (gi) {
+    case GI_1_32:
+      return vlength / 32;
+    case GI_1_16:
+      return vlength / 16;
+    case GI_1_8:
+      return vlength / 8;
+    case GI_1_4:
+      return vlength / 4;
+    case GI_1_128:
+      return vlength / 128;
+    case GI_19_128:
+      return (vlength * 19) / 128;
+    case GI_19_256:
+      return (vlength * 19) / 256;
+  }
+  return 0;
+}
+
+/* The longest frame (in data symbols) that fits in MAX_FRAME_LENGTH */
+static int
+data_symbols(const fft_mode &mode, dvbt2_guardinterval_t gi)
+{
+  int symbol = mode.vlength + guard_length(mode.vlength, gi);
+
+  return (int)((MAX_FRAME_LENGTH * SAMPLE_RATE - 2048) / symbol) - mode.n_p2;
+}
+
+static uint32_t lcg_state = 1;
+
+static inline uint32_t
+lcg_next(void)
+{
+  lcg_state = lcg_state * 1664525 + 1013904223;
+  return lcg_state >> 8;
+}
+
+static void
+fill_ts(std::vector<unsigned char> &buf)
+{
+  for (size_t i = 0; i < buf.size(); i++) {
+    buf[i] = (i % 188) == 0 ? 0x47 : lcg_next() & 0xff;
+  }
+}
+
+static void
+fill_bits(std::vector<unsigned char> &buf)
+{
+  for (size_t i = 0; i < buf.size(); i++) {
+    buf[i] = lcg_next() & 0x1;
+  }
+}
+
+static void
+fill_cells(std::vector<gr_complex> &buf)
+{
+  for (size_t i = 0; i < buf.size(); i++) {
+    buf[i] = gr_complex(((lcg_next() & 0x1) ? 0.7071f : -0.7071f), ((lcg_next() & 0x1) ? 0.7071f : -0.7071f));
+  }
+}
+
+/*
+ * Gives the block a detail with one input and one output buffer, so
+ * consume_each(), nitems_read() and nitems_written() work without a
+ * flowgraph. The items themselves are passed to general_work()
+ * directly.
+ */
+static void
+attach_detail(gr::block_sptr blk, size_t in_size, size_t out_size)
+{
+  gr::block_detail_sptr detail = gr::make_block_detail(1, 1);
+  gr::buffer_sptr in_buf = gr::make_buffer(4096, in_size, blk);
+
+  detail->set_input(0, gr::buffer_add_reader(in_buf, 0, blk));
+  detail->set_output(0, gr::make_buffer(4096, out_size, blk));
+  blk->set_detail(detail);
+}
+
+/*
+ * Calls general_work() with noutput_items until min_time seconds have
+ * passed (after one warm-up call) and returns the mean ns per call.
+ * The input is replayed from the start on every call, offset by the
+ * items consumed modulo period so a Transport Stream stays in sync.
+ */
+static double
+time_work(gr::block_sptr blk, const void *in, size_t item_size, int period, int ninput, void *out, int noutput_items, double min_time, int &calls)
+{
+  gr_vector_int ninput_items(1, ninput);
+  gr_vector_const_void_star input_items(1, in);
+  gr_vector_void_star output_items(1, out);
+  std::chrono::steady_clock::time_point start, now;
+  double elapsed;
+  int produced;
+
+  produced = blk->general_work(noutput_items, ninput_items, input_items, output_items);
+  blk->detail()->produce_each(produced);
+  calls = 0;
+  start = std::chrono::steady_clock::now();
+  do {
+    ninput_items[0] = ninput;
+    input_items[0] = (const char *)in + (blk->nitems_read(0) % period) * item_size;
+    produced = blk->general_work(noutput_items, ninput_items, input_items, output_items);
+    blk->detail()->produce_each(produced);
+    calls++;
+    now = std::chrono::steady_clock::now();
+    elapsed = std::chrono::duration<double>(now - start).count();
+  } while (elapsed < min_time || calls < 2);
+  return elapsed * 1e9 / calls;
+}
+
+static int
+required_input(gr::block_sptr blk, int noutput_items)
+{
+  gr_vector_int ninput_items_required(1, 0);
+
+  blk->forecast(noutput_items, ninput_items_required);
+  return ninput_items_required[0];
+}
+
+static bench_result
+bench_bbheader(dvbt2_framesize_t framesize, dvbt2_code_rate_t rate, double min_time)
+{
+  const int frames = 8;
+  bbheaderbch_bb::sptr blk = bbheaderbch_bb::make(framesize, rate, INPUTMODE_NORMAL, INBAND_OFF, frames, 0);
+  int nbch = blk->output_multiple();
+  int frame_in = required_input(blk, nbch);
+  std::vector<unsigned char> in((frame_in * frames) + 188);
+  std::vector<unsigned char> out(nbch * frames);
+  std::ostringstream params;
+  bench_result r;
+  double ns;
+
+  fill_ts(in);
+  attach_detail(blk, sizeof(unsigned char), sizeof(unsigned char));
+  ns = time_work(blk, &in[0], sizeof(unsigned char), 188, in.size() - 188, &out[0], out.size(), min_time, r.calls);
+  params << "\"framesize\": \"" << framesize_names[framesize] << "\", \"rate\": \"" << rate_names[rate] << "\"";
+  r.block = "bbheaderbch_bb";
+  r.params = params.str();
+  r.frames = frames;
+  r.ns_per_frame = ns / frames;
+  r.mbps = (kbch_size(framesize, rate) - 80) * 1e3 / r.ns_per_frame;
+  r.rtf = r.mbps * 1e6 / REFERENCE_RATE;
+  return r;
+}
+
+static bench_result
+bench_interleavermod(dvbt2_framesize_t framesize, dvbt2_code_rate_t rate, dvbt2_constellation_t constellation, double min_time)
+{
+  const int frames = 8;
+  interleavermod_bc::sptr blk = interleavermod_bc::make(framesize, rate, constellation, ROTATION_OFF);
+  int cell_size = blk->output_multiple();
+  std::vector<unsigned char> in(required_input(blk, cell_size * frames));
+  std::vector<gr_complex> out(cell_size * frames);
+  std::ostringstream params;
+  bench_result r;
+  double ns;
+
+  fill_bits(in);
+  attach_detail(blk, sizeof(unsigned char), sizeof(gr_complex));
+  ns = time_work(blk, &in[0], sizeof(unsigned char), 1, in.size(), &out[0], out.size(), min_time, r.calls);
+  params << "\"framesize\": \"" << framesize_names[framesize] << "\", \"rate\": \"" << rate_names[rate] << "\", \"constellation\": \"" << constellation_names[constellation] << "\"";
+  r.block = "interleavermod_bc";
+  r.params = params.str();
+  r.frames = frames;
+  r.ns_per_frame = ns / frames;
+  r.mbps = (kbch_size(framesize, rate) - 80) * 1e3 / r.ns_per_frame;
+  r.rtf = r.mbps * 1e6 / REFERENCE_RATE;
+  return r;
+}
+
+static framemapperfint_cc::sptr
+make_framemapper(dvbt2_framesize_t framesize, dvbt2_constellation_t constellation, const fft_mode &mode, dvbt2_pilotpattern_t pilot, dvbt2_guardinterval_t gi, int fecblocks)
+{
+  return framemapperfint_cc::make(framesize, C2_3, constellation, ROTATION_OFF, fecblocks, 1, CARRIERS_NORMAL, mode.fftsize, gi, L1_MOD_16QAM, pilot, 2, data_symbols(mode, gi), PAPR_OFF, VERSION_131, PREAMBLE_T2_SISO, INPUTMODE_NORMAL, RESERVED_OFF, L1_SCRAMBLED_OFF, INBAND_OFF);
+}
+
+/*
+ * The frame mapper is filled with as many FEC blocks as fit, leaving
+ * a tenth of the frame plus room for the L1 and the frame closing
+ * symbol as dummy cells. The code rate only changes the L1 fields.
+ */
+static bench_result
+bench_framemapper(dvbt2_framesize_t framesize, dvbt2_constellation_t constellation, const fft_mode &mode, dvbt2_pilotpattern_t pilot, double min_time)
+{
+  static const int bits[4] = {2, 4, 6, 8};
+  dvbt2_guardinterval_t gi = pilot_gi[&mode - fft_modes][pilot];
+  int cell_size = (framesize == FECFRAME_NORMAL ? FRAME_SIZE_NORMAL : FRAME_SIZE_SHORT) / bits[constellation];
+  int total_cells = make_framemapper(framesize, constellation, mode, pilot, gi, 1)->output_multiple();
+  int fecblocks = std::max((total_cells - (total_cells / 10) - 1840 - 8000) / cell_size, 1);
+  framemapperfint_cc::sptr blk = make_framemapper(framesize, constellation, mode, pilot, gi, fecblocks);
+  int symbols = mode.n_p2 + data_symbols(mode, gi);
+  std::vector<gr_complex> in(required_input(blk, total_cells));
+  std::vector<gr_complex> out(total_cells);
+  std::ostringstream params;
+  bench_result r;
+  double ns;
+
+  fill_cells(in);
+  attach_detail(blk, sizeof(gr_complex), sizeof(gr_complex));
+  blk->start();
+  ns = time_work(blk, &in[0], sizeof(gr_complex), 1, in.size(), &out[0], out.size(), min_time, r.calls);
+  blk->stop();
+  params << "\"framesize\": \"" << framesize_names[framesize] << "\", \"constellation\": \"" << constellation_names[constellation] << "\", \"fftsize\": \"" << mode.name << "\", \"pilotpattern\": \"" << pilot_names[pilot] << "\", \"guardinterval\": \"" << gi_names[gi] << "\", \"fecblocks\": " << fecblocks;
+  r.block = "framemapperfint_cc";
+  r.params = params.str();
+  r.frames = 1;
+  r.ns_per_frame = ns;
+  r.mbps = fecblocks * (kbch_size(framesize, C2_3) - 80) * 1e3 / ns;
+  r.rtf = ((symbols * (mode.vlength + guard_length(mode.vlength, gi))) + 2048) / SAMPLE_RATE / (ns * 1e-9);
+  return r;
+}
+
+/*
+ * The pilot generator carries no FEC information, so its Mbit/s is
+ * the 32-bit I/Q sample rate it produces.
+ */
+static bench_result
+bench_pilotgen(const fft_mode &mode, dvbt2_pilotpattern_t pilot, double min_time)
+{
+  dvbt2_guardinterval_t gi = pilot_gi[&mode - fft_modes][pilot];
+  pilotgenp1insert_cc::sptr blk = pilotgenp1insert_cc::make(CARRIERS_NORMAL, mode.fftsize, pilot, gi, data_symbols(mode, gi), PAPR_OFF, VERSION_131, PREAMBLE_T2_SISO, MISO_TX1, EQUALIZATION_ON, BANDWIDTH_8_0_MHZ, mode.vlength);
+  int frame_items = blk->output_multiple();
+  std::vector<gr_complex> in(required_input(blk, frame_items));
+  std::vector<gr_complex> out(frame_items);
+  std::ostringstream params;
+  bench_result r;
+  double ns;
+
+  fill_cells(in);
+  attach_detail(blk, sizeof(gr_complex), sizeof(gr_complex));
+  ns = time_work(blk, &in[0], sizeof(gr_complex), 1, in.size(), &out[0], out.size(), min_time, r.calls);
+  params << "\"fftsize\": \"" << mode.name << "\", \"pilotpattern\": \"" << pilot_names[pilot] << "\", \"guardinterval\": \"" << gi_names[gi] << "\"";
+  r.block = "pilotgenp1insert_cc";
+  r.params = params.str();
+  r.frames = 1;
+  r.ns_per_frame = ns;
+  r.mbps = frame_items * 64 * 1e3 / ns;
+  r.rtf = frame_items / SAMPLE_RATE / (ns * 1e-9);
+  return r;
+}
+
+static std::string
+cpu_name(void)
+{
+  std::ifstream cpuinfo("/proc/cpuinfo");
+  std::string line;
+
+  while (std::getline(cpuinfo, line)) {
+    if (line.compare(0, 10, "model name") == 0) {
+      std::string::size_type colon = line.find(':');
+      if (colon != std::string::npos) {
+        return line.substr(colon + 2);
+      }
+    }
+  }
+  return "unknown";
+}
+
+static void
+report(std::vector<bench_result> &results, bench_result r)
+{
+  r.arch = cpu_arch_name(cpu_kernels_selected().arch);
+  fprintf(stderr, "%-20s %-7s %-100s %12.0f ns/frame %9.2f Mbit/s %8.2f x\n", r.block.c_str(), r.arch.c_str(), r.params.c_str(), r.ns_per_frame, r.mbps, r.rtf);
+  results.push_back(r);
+}
+
+static void
+write_json(std::ostream &os, const std::vector<bench_result> &results, double min_time)
+{
+  os << "{\n";
+  os << "  \"benchmark\": \"bench-dvbt2ll\",\n";
+  os << "  \"cpu\": \"" << cpu_name() << "\",\n";
+  os << "  \"cpu_arch\": \"" << cpu_arch_name(cpu_arch_supported()) << "\",\n";
+  os << "  \"min_time\": " << min_time << ",\n";
+  os << "  \"sample_rate\": " << SAMPLE_RATE << ",\n";
+  os << "  \"reference_rate\": " << REFERENCE_RATE << ",\n";
+  os << "  \"results\": [\n";
+  for (size_t i = 0; i < results.size(); i++) {
+    const bench_result &r = results[i];
+    os << "    {\"block\": \"" << r.block << "\", \"arch\": \"" << r.arch << "\", " << r.params
+       << ", \"calls\": " << r.calls << ", \"frames_per_call\": " << r.frames
+       << ", \"ns_per_frame\": " << r.ns_per_frame << ", \"mbps\": " << r.mbps
+       << ", \"rtf\": " << r.rtf << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+  }
+  os << "  ]\n";
+  os << "}\n";
+}
+
+int
+main(int argc, char **argv)
+{
+  std::vector<bench_result> results;
+  std::string filename;
+  std::string only;
+  std::string arch;
+  double min_time = 0.25;
+  const dvbt2_framesize_t framesizes[2] = {FECFRAME_NORMAL, FECFRAME_SHORT};
+
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+      filename = argv[++i];
+    }
+    else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+      min_time = atof(argv[++i]);
+    }
+    else if (strcmp(argv[i], "-b") == 0 && i + 1 < argc) {
+      only = argv[++i];
+    }
+    else if (strcmp(argv[i], "-a") == 0 && i + 1 < argc) {
+      arch = argv[++i];
+    }
+    else {
+      fprintf(stderr, "usage: %s [-o file.json] [-t seconds] [-b block] [-a arch]\n", argv[0]);
+      return 1;
+    }
+  }
+
+  for (int a = CPU_GENERIC; a < CPU_ARCHS; a++) {
+    if (!arch.empty() && arch != cpu_arch_name((cpu_arch_t)a)) {
+      continue;
+    }
+    if (!cpu_arch_select((cpu_arch_t)a)) {
+      if (!arch.empty()) {
+        fprintf(stderr, "%s kernels are not available on this CPU\n", arch.c_str());
+        return 1;
+      }
+      continue;
+    }
+    for (int f = 0; f < 2; f++) {
+      for (int rate = C1_2; rate <= C2_5; rate++) {
+        if (kbch_size(framesizes[f], (dvbt2_code_rate_t)rate) == 0) {
+          continue;
+        }
+        if (only.empty() || only == "bbheaderbch_bb") {
+          report(results, bench_bbheader(framesizes[f], (dvbt2_code_rate_t)rate, min_time));
+        }
+        if (only.empty() || only == "interleavermod_bc") {
+          for (int c = MOD_QPSK; c <= MOD_256QAM; c++) {
+            report(results, bench_interleavermod(framesizes[f], (dvbt2_code_rate_t)rate, (dvbt2_constellation_t)c, min_time));
+          }
+        }
+      }
+    }
+  }
+  for (size_t m = 0; m < sizeof(fft_modes) / sizeof(fft_modes[0]); m++) {
+    for (int p = PILOT_PP1; p <= PILOT_PP8; p++) {
+      if (pilot_gi[m][p] == no_gi) {
+        continue;
+      }
+      if (only.empty() || only == "framemapperfint_cc") {
+        for (int f = 0; f < 2; f++) {
+          for (int c = MOD_QPSK; c <= MOD_256QAM; c++) {
+            report(results, bench_framemapper(framesizes[f], (dvbt2_constellation_t)c, fft_modes[m], (dvbt2_pilotpattern_t)p, min_time));
+          }
+        }
+      }
+      if (only.empty() || only == "pilotgenp1insert_cc") {
+        report(results, bench_pilotgen(fft_modes[m], (dvbt2_pilotpattern_t)p, min_time));
+      }
+    }
+  }
+
+  if (filename.empty()) {
+    write_json(std::cout, results, min_time);
+  }
+  else {
+    std::ofstream json(filename.c_str());
+    if (!json) {
+      fprintf(stderr, "cannot open %s\n", filename.c_str());
+      return 1;
+    }
+    write_json(json, results, min_time);
+  }
+  return 0;
+}
@@ -0,0 +1,100 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2017 Ron Economos.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_DVBT2LL_CELL_MODULATOR_IMPL_H
+#define INCLUDED_DVBT2LL_CELL_MODULATOR_IMPL_H
+
+#include <dvbt2ll/cell_modulator.h>
+#include "cpu_dispatch.h"
+
+namespace gr {
+  namespace dvbt2ll {
+
+    class DVBT2LL_CORE_API cell_modulator_impl : public cell_modulator
+    {
+     private:
+      int frame_size;
+      int signal_constellation;
+      int code_rate;
+      int nbch;
+      int q_val;
+      int mod;
+      int cyclic_delay;
+      int cell_size;
+      unsigned char tempu[FRAME_SIZE_NORMAL];
+      unsigned char tempv[FRAME_SIZE_NORMAL];
+      const cpu_kernels *kernels;
+
+      const static int twist16n[8];
+      const static int twist64n[12];
+      const static int twist256n[16];
+
+      const static int twist16s[8];
+      const static int twist64s[12];
+      const static int twist256s[8];
+
+      const static int mux16[8];
+      const static int mux64[12];
+      const static int mux256[16];
+
+      const static int mux16_35[8];
+      const static int mux16_13[8];
+      const static int mux16_25[8];
+      const static int mux64_35[12];
+      const static int mux64_13[12];
+      const static int mux64_25[12];
+      const static int mux256_35[16];
+      const static int mux256_23[16];
+
+      const static int mux256s[8];
+      const static int mux256s_13[8];
+      const static int mux256s_25[8];
+
+      gr_complex m_qpsk[4];
+      gr_complex m_16qam[16];
+      gr_complex m_64qam[64];
+      gr_complex m_256qam[256];
+      lv_16sc_t m_qpsk_sc16[4];
+      lv_16sc_t m_16qam_sc16[16];
+      lv_16sc_t m_64qam_sc16[64];
+      lv_16sc_t m_256qam_sc16[256];
+
+      void map_block(gr_complex *out) const;
+      void map_block(lv_16sc_t *out) const;
+      template <class T> int process_cells(const unsigned char *in, T *out, int blocks);
+
+     public:
+      cell_modulator_impl(dvbt2_framesize_t framesize, dvbt2_code_rate_t rate, dvbt2_constellation_t constellation, dvbt2_rotation_t rotation);
+      ~cell_modulator_impl();
+
+      int input_items() const { return frame_size; }
+      int output_items() const { return cell_size; }
+      int process(const unsigned char *in, gr_complex *out, int blocks);
+      int process(const unsigned char *in, lv_16sc_t *out, int blocks);
+      void set_constellation(dvbt2_constellation_t constellation, dvbt2_rotation_t rotation);
+
+      int constellation() const { return signal_constellation; }
+      int rotation() const { return cyclic_delay; }
+    };
+
+  } // namespace dvbt2ll
+} // namespace gr
+
+#endif /* INCLUDED_DVBT2LL_CELL_MODULATOR_IMPL_H */
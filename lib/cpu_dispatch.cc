@@ -0,0 +1,147 @@
+/* -*- c++ -*- */
+/* 
+ * Copyright 2017 Ron Economos.
+ * 
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ * 
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "cpu_dispatch.h"
+#include <gnuradio/logger.h>
+#include <boost/atomic.hpp>
+#include <algorithm>
+#include <string>
+#include <stdlib.h>
+#include <string.h>
+
+namespace gr {
+  namespace dvbt2ll {
+
+    static const char *arch_names[CPU_ARCHS] = {"generic", "sse4.2", "avx2", "avx512"};
+
+    /* Set by cpu_arch_select(), ahead of the variant picked at start up */
+    static boost::atomic<const cpu_kernels *> forced_kernels(NULL);
+
+    cpu_arch_t
+    cpu_arch_supported(void)
+    {
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+      __builtin_cpu_init();
+      if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")) {
+        return CPU_AVX512;
+      }
+      if (__builtin_cpu_supports("avx2")) {
+        return CPU_AVX2;
+      }
+      if (__builtin_cpu_supports("sse4.2")) {
+        return CPU_SSE42;
+      }
+#endif
+      return CPU_GENERIC;
+    }
+
+    const char *
+    cpu_arch_name(cpu_arch_t arch)
+    {
+      if (arch < CPU_GENERIC || arch >= CPU_ARCHS) {
+        return "unknown";
+      }
+      return arch_names[arch];
+    }
+
+    const cpu_kernels *
+    cpu_kernels_for(cpu_arch_t arch)
+    {
+      if (arch > cpu_arch_supported()) {
+        return NULL;
+      }
+      switch (arch) {
+        case CPU_GENERIC:
+          return cpu_kernels_generic();
+        case CPU_SSE42:
+          return cpu_kernels_sse42();
+        case CPU_AVX2:
+          return cpu_kernels_avx2();
+        case CPU_AVX512:
+          return cpu_kernels_avx512();
+        default:
+          return NULL;
+      }
+    }
+
+    /*
+     * The highest variant that is built in, runs on this CPU and isn't
+     * above DVBT2LL_CPU.
+     */
+    static const cpu_kernels *
+    pick_kernels(void)
+    {
+      GR_LOG_GETLOGGER(logger, "dvbt2ll");
+      cpu_arch_t supported = cpu_arch_supported();
+      cpu_arch_t cap = CPU_AVX512;
+      const char *env = getenv(CPU_DISPATCH_ENV);
+      const cpu_kernels *kernels = NULL;
+
+      if (env != NULL && *env != '\0') {
+        int a;
+        for (a = CPU_GENERIC; a < CPU_ARCHS; a++) {
+          if (strcasecmp(env, arch_names[a]) == 0) {
+            break;
+          }
+        }
+        if (a == CPU_ARCHS) {
+          GR_LOG_WARN(logger, std::string("DVB-T2LL, unknown ") + CPU_DISPATCH_ENV + "=" + env + " ignored.");
+        }
+        else {
+          cap = (cpu_arch_t)a;
+          if (cap > supported) {
+            GR_LOG_WARN(logger, std::string("DVB-T2LL, ") + CPU_DISPATCH_ENV + "=" + env + " is more than this CPU has (" + arch_names[supported] + ").");
+          }
+        }
+      }
+      for (int a = std::min(cap, supported); a >= CPU_GENERIC && kernels == NULL; a--) {
+        kernels = cpu_kernels_for((cpu_arch_t)a);
+      }
+      GR_LOG_INFO(logger, std::string("DVB-T2LL, using the ") + arch_names[kernels->arch] + " kernels (CPU " + arch_names[supported] + ").");
+      return kernels;
+    }
+
+    const cpu_kernels &
+    cpu_kernels_selected(void)
+    {
+      static const cpu_kernels *picked = pick_kernels();
+      const cpu_kernels *kernels = forced_kernels.load();
+
+      return kernels != NULL ? *kernels : *picked;
+    }
+
+    bool
+    cpu_arch_select(cpu_arch_t arch)
+    {
+      const cpu_kernels *kernels = cpu_kernels_for(arch);
+
+      if (kernels == NULL) {
+        return false;
+      }
+      forced_kernels.store(kernels);
+      return true;
+    }
+
+  } /* namespace dvbt2ll */
+} /* namespace gr */
@@ -0,0 +1,97 @@
+/* -*- c++ -*- */
+/* 
+ * Copyright 2017 Ron Economos.
+ * 
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ * 
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_DVBT2LL_CPU_DISPATCH_H
+#define INCLUDED_DVBT2LL_CPU_DISPATCH_H
+
+#include <dvbt2ll/api.h>
+#include <gnuradio/gr_complex.h>
+
+/* Environment variable that caps the kernels picked, for A/B runs */
+#define CPU_DISPATCH_ENV "DVBT2LL_CPU"
+
+namespace gr {
+  namespace dvbt2ll {
+
+    /* Kernel variants, each level runs on the CPUs of the next ones */
+    enum cpu_arch_t {
+      CPU_GENERIC = 0,
+      CPU_SSE42,
+      CPU_AVX2,
+      CPU_AVX512,
+      CPU_ARCHS
+    };
+
+    /*
+     * The SIMD kernels of the hot loops. There is one table per
+     * variant, each built from its own cpu_kernels_<arch>.cc with the
+     * matching compiler flags, and every variant gives the same output
+     * bit for bit.
+     */
+    struct cpu_kernels
+    {
+      cpu_arch_t arch;
+
+      /* dst[i] ^= src[i] */
+      void (*xor_bytes)(unsigned char *dst, const unsigned char *src, int length);
+
+      /* out[i] = table[in[i] & mask] */
+      void (*map_cells)(const unsigned char *in, const gr_complex *table, int mask, gr_complex *out, int length);
+
+      /*
+       * The same with the cyclic Q delay of rotated constellations:
+       * the imaginary part comes from in[i - 1], and from the last
+       * cell for i = 0.
+       */
+      void (*map_cells_delayed)(const unsigned char *in, const gr_complex *table, int mask, gr_complex *out, int length);
+    };
+
+    const cpu_kernels *cpu_kernels_generic(void);
+    const cpu_kernels *cpu_kernels_sse42(void);
+    const cpu_kernels *cpu_kernels_avx2(void);
+    const cpu_kernels *cpu_kernels_avx512(void);
+
+    /* Highest variant the CPU runs */
+    DVBT2LL_CORE_API cpu_arch_t cpu_arch_supported(void);
+
+    DVBT2LL_CORE_API const char *cpu_arch_name(cpu_arch_t arch);
+
+    /* The table of arch, NULL if it isn't built in or the CPU can't run it */
+    DVBT2LL_CORE_API const cpu_kernels *cpu_kernels_for(cpu_arch_t arch);
+
+    /*
+     * The table the core objects take when they are made. The first
+     * call picks the highest variant that is built in and runs on the
+     * CPU, capped by DVBT2LL_CPU (generic, sse4.2, avx2 or avx512),
+     * and logs the choice.
+     */
+    DVBT2LL_CORE_API const cpu_kernels &cpu_kernels_selected(void);
+
+    /*
+     * Makes arch the selected variant for objects made from now on,
+     * for benchmarks and tests. Returns false, and changes nothing,
+     * if cpu_kernels_for(arch) is NULL.
+     */
+    DVBT2LL_CORE_API bool cpu_arch_select(cpu_arch_t arch);
+
+  } // namespace dvbt2ll
+} // namespace gr
+
+#endif /* INCLUDED_DVBT2LL_CPU_DISPATCH_H */
@@ -0,0 +1,135 @@
+/* -*- c++ -*- */
+/* 
+ * Copyright 2017 Ron Economos.
+ * 
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ * 
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "cpu_dispatch.h"
+#include <string.h>
+
+/*
+ * AVX2 variant, built with -mavx2. The cells are gathered four at a
+ * time, each complex<float> as one double.
+ */
+
+#ifdef __AVX2__
+#include <immintrin.h>
+
+namespace gr {
+  namespace dvbt2ll {
+
+    static void
+    xor_bytes(unsigned char *dst, const unsigned char *src, int length)
+    {
+      int i = 0;
+
+      for (; i + 32 <= length; i += 32) {
+        __m256i a = _mm256_loadu_si256((const __m256i *)&dst[i]);
+        __m256i b = _mm256_loadu_si256((const __m256i *)&src[i]);
+        _mm256_storeu_si256((__m256i *)&dst[i], _mm256_xor_si256(a, b));
+      }
+      for (; i < length; i++) {
+        dst[i] ^= src[i];
+      }
+    }
+
+    static inline __m256d
+    gather4(const double *t, const unsigned char *in, __m128i mask)
+    {
+      int bytes;
+
+      memcpy(&bytes, in, sizeof(bytes));
+      __m128i index = _mm_and_si128(_mm_cvtepu8_epi32(_mm_cvtsi32_si128(bytes)), mask);
+      return _mm256_i32gather_pd(t, index, 8);
+    }
+
+    static void
+    map_cells(const unsigned char *in, const gr_complex *table, int mask, gr_complex *out, int length)
+    {
+      const double *t = (const double *)table;
+      double *o = (double *)out;
+      __m128i m = _mm_set1_epi32(mask);
+      int i = 0;
+
+      for (; i + 4 <= length; i += 4) {
+        _mm256_storeu_pd(&o[i], gather4(t, &in[i], m));
+      }
+      for (; i < length; i++) {
+        o[i] = t[in[i] & mask];
+      }
+    }
+
+    static void
+    map_cells_delayed(const unsigned char *in, const gr_complex *table, int mask, gr_complex *out, int length)
+    {
+      const double *t = (const double *)table;
+      const float *tf = (const float *)table;
+      float *o = (float *)out;
+      __m128i m = _mm_set1_epi32(mask);
+      int i = 1;
+
+      if (length <= 0) {
+        return;
+      }
+      o[0] = tf[(in[0] & mask) * 2];
+      o[1] = tf[(in[length - 1] & mask) * 2 + 1];
+      for (; i + 4 <= length; i += 4) {
+        __m256 re = _mm256_castpd_ps(gather4(t, &in[i], m));
+        __m256 im = _mm256_castpd_ps(gather4(t, &in[i - 1], m));
+        _mm256_storeu_ps(&o[i * 2], _mm256_blend_ps(re, im, 0xaa));
+      }
+      for (; i < length; i++) {
+        o[i * 2] = tf[(in[i] & mask) * 2];
+        o[i * 2 + 1] = tf[(in[i - 1] & mask) * 2 + 1];
+      }
+    }
+
+    static const cpu_kernels kernels = {
+      CPU_AVX2,
+      xor_bytes,
+      map_cells,
+      map_cells_delayed
+    };
+
+    const cpu_kernels *
+    cpu_kernels_avx2(void)
+    {
+      return &kernels;
+    }
+
+  } /* namespace dvbt2ll */
+} /* namespace gr */
+
+#else
+
+namespace gr {
+  namespace dvbt2ll {
+
+    const cpu_kernels *
+    cpu_kernels_avx2(void)
+    {
+      return NULL;
+    }
+
+  } /* namespace dvbt2ll */
+} /* namespace gr */
+
+#endif /* __AVX2__ */
@@ -0,0 +1,135 @@
+/* -*- c++ -*- */
+/* 
+ * Copyright 2017 Ron Economos.
+ * 
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ * 
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "cpu_dispatch.h"
+#include <string.h>
+
+/*
+ * AVX-512 variant, built with -mavx512f -mavx512bw. Eight cells per
+ * gather.
+ */
+
+#if defined(__AVX512F__) && defined(__AVX512BW__)
+#include <immintrin.h>
+
+namespace gr {
+  namespace dvbt2ll {
+
+    static void
+    xor_bytes(unsigned char *dst, const unsigned char *src, int length)
+    {
+      int i = 0;
+
+      for (; i + 64 <= length; i += 64) {
+        __m512i a = _mm512_loadu_si512((const void *)&dst[i]);
+        __m512i b = _mm512_loadu_si512((const void *)&src[i]);
+        _mm512_storeu_si512((void *)&dst[i], _mm512_xor_si512(a, b));
+      }
+      for (; i < length; i++) {
+        dst[i] ^= src[i];
+      }
+    }
+
+    static inline __m512d
+    gather8(const double *t, const unsigned char *in, __m256i mask)
+    {
+      long long bytes;
+
+      memcpy(&bytes, in, sizeof(bytes));
+      __m256i index = _mm256_and_si256(_mm256_cvtepu8_epi32(_mm_cvtsi64_si128(bytes)), mask);
+      return _mm512_i32gather_pd(index, t, 8);
+    }
+
+    static void
+    map_cells(const unsigned char *in, const gr_complex *table, int mask, gr_complex *out, int length)
+    {
+      const double *t = (const double *)table;
+      double *o = (double *)out;
+      __m256i m = _mm256_set1_epi32(mask);
+      int i = 0;
+
+      for (; i + 8 <= length; i += 8) {
+        _mm512_storeu_pd(&o[i], gather8(t, &in[i], m));
+      }
+      for (; i < length; i++) {
+        o[i] = t[in[i] & mask];
+      }
+    }
+
+    static void
+    map_cells_delayed(const unsigned char *in, const gr_complex *table, int mask, gr_complex *out, int length)
+    {
+      const double *t = (const double *)table;
+      const float *tf = (const float *)table;
+      float *o = (float *)out;
+      __m256i m = _mm256_set1_epi32(mask);
+      int i = 1;
+
+      if (length <= 0) {
+        return;
+      }
+      o[0] = tf[(in[0] & mask) * 2];
+      o[1] = tf[(in[length - 1] & mask) * 2 + 1];
+      for (; i + 8 <= length; i += 8) {
+        __m512 re = _mm512_castpd_ps(gather8(t, &in[i], m));
+        __m512 im = _mm512_castpd_ps(gather8(t, &in[i - 1], m));
+        _mm512_storeu_ps(&o[i * 2], _mm512_mask_blend_ps(0xaaaa, re, im));
+      }
+      for (; i < length; i++) {
+        o[i * 2] = tf[(in[i] & mask) * 2];
+        o[i * 2 + 1] = tf[(in[i - 1] & mask) * 2 + 1];
+      }
+    }
+
+    static const cpu_kernels kernels = {
+      CPU_AVX512,
+      xor_bytes,
+      map_cells,
+      map_cells_delayed
+    };
+
+    const cpu_kernels *
+    cpu_kernels_avx512(void)
+    {
+      return &kernels;
+    }
+
+  } /* namespace dvbt2ll */
+} /* namespace gr */
+
+#else
+
+namespace gr {
+  namespace dvbt2ll {
+
+    const cpu_kernels *
+    cpu_kernels_avx512(void)
+    {
+      return NULL;
+    }
+
+  } /* namespace dvbt2ll */
+} /* namespace gr */
+
+#endif /* __AVX512F__ && __AVX512BW__ */
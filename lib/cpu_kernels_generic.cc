@@ -0,0 +1,74 @@
+/* -*- c++ -*- */
+/* 
+ * Copyright 2017 Ron Economos.
+ * 
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ * 
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "cpu_dispatch.h"
+
+/*
+ * Plain C, the reference the other variants are checked against.
+ * Built without any ISA flags, so it runs on every CPU.
+ */
+
+namespace gr {
+  namespace dvbt2ll {
+
+    static void
+    xor_bytes(unsigned char *dst, const unsigned char *src, int length)
+    {
+      for (int i = 0; i < length; i++) {
+        dst[i] ^= src[i];
+      }
+    }
+
+    static void
+    map_cells(const unsigned char *in, const gr_complex *table, int mask, gr_complex *out, int length)
+    {
+      for (int i = 0; i < length; i++) {
+        out[i] = table[in[i] & mask];
+      }
+    }
+
+    static void
+    map_cells_delayed(const unsigned char *in, const gr_complex *table, int mask, gr_complex *out, int length)
+    {
+      for (int i = 0; i < length; i++) {
+        int delay = in[(i + length - 1) % length];
+        out[i] = gr_complex(table[in[i] & mask].real(), table[delay & mask].imag());
+      }
+    }
+
+    static const cpu_kernels kernels = {
+      CPU_GENERIC,
+      xor_bytes,
+      map_cells,
+      map_cells_delayed
+    };
+
+    const cpu_kernels *
+    cpu_kernels_generic(void)
+    {
+      return &kernels;
+    }
+
+  } /* namespace dvbt2ll */
+} /* namespace gr */
@@ -0,0 +1,129 @@
+/* -*- c++ -*- */
+/* 
+ * Copyright 2017 Ron Economos.
+ * 
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ * 
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "cpu_dispatch.h"
+
+/*
+ * SSE4.2 variant, built with -msse4.2. Only plain C types are used
+ * here, so no inline function of a shared header is emitted with
+ * instructions older CPUs don't have.
+ */
+
+#ifdef __SSE4_2__
+#include <smmintrin.h>
+
+namespace gr {
+  namespace dvbt2ll {
+
+    static void
+    xor_bytes(unsigned char *dst, const unsigned char *src, int length)
+    {
+      int i = 0;
+
+      for (; i + 16 <= length; i += 16) {
+        __m128i a = _mm_loadu_si128((const __m128i *)&dst[i]);
+        __m128i b = _mm_loadu_si128((const __m128i *)&src[i]);
+        _mm_storeu_si128((__m128i *)&dst[i], _mm_xor_si128(a, b));
+      }
+      for (; i < length; i++) {
+        dst[i] ^= src[i];
+      }
+    }
+
+    /* two cells, as one 64-bit load each */
+    static inline __m128
+    load_pair(const double *t, int a, int b)
+    {
+      return _mm_castpd_ps(_mm_loadh_pd(_mm_load_sd(&t[a]), &t[b]));
+    }
+
+    static void
+    map_cells(const unsigned char *in, const gr_complex *table, int mask, gr_complex *out, int length)
+    {
+      const double *t = (const double *)table;
+      double *o = (double *)out;
+      int i = 0;
+
+      for (; i + 2 <= length; i += 2) {
+        _mm_storeu_ps((float *)&o[i], load_pair(t, in[i] & mask, in[i + 1] & mask));
+      }
+      for (; i < length; i++) {
+        o[i] = t[in[i] & mask];
+      }
+    }
+
+    static void
+    map_cells_delayed(const unsigned char *in, const gr_complex *table, int mask, gr_complex *out, int length)
+    {
+      const float *t = (const float *)table;
+      float *o = (float *)out;
+      int i = 1;
+
+      if (length <= 0) {
+        return;
+      }
+      o[0] = t[(in[0] & mask) * 2];
+      o[1] = t[(in[length - 1] & mask) * 2 + 1];
+      for (; i + 2 <= length; i += 2) {
+        __m128 re = load_pair((const double *)t, in[i] & mask, in[i + 1] & mask);
+        __m128 im = load_pair((const double *)t, in[i - 1] & mask, in[i] & mask);
+        _mm_storeu_ps(&o[i * 2], _mm_blend_ps(re, im, 0xa));
+      }
+      for (; i < length; i++) {
+        o[i * 2] = t[(in[i] & mask) * 2];
+        o[i * 2 + 1] = t[(in[i - 1] & mask) * 2 + 1];
+      }
+    }
+
+    static const cpu_kernels kernels = {
+      CPU_SSE42,
+      xor_bytes,
+      map_cells,
+      map_cells_delayed
+    };
+
+    const cpu_kernels *
+    cpu_kernels_sse42(void)
+    {
+      return &kernels;
+    }
+
+  } /* namespace dvbt2ll */
+} /* namespace gr */
+
+#else
+
+namespace gr {
+  namespace dvbt2ll {
+
+    const cpu_kernels *
+    cpu_kernels_sse42(void)
+    {
+      return NULL;
+    }
+
+  } /* namespace dvbt2ll */
+} /* namespace gr */
+
+#endif /* __SSE4_2__ */
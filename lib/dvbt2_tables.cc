@@ -0,0 +1,159 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2017 Ron Economos.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "dvbt2_tables.h"
+
+namespace gr {
+  namespace dvbt2ll {
+
+    namespace {
+
+      template <int N>
+      constexpr const_table<unsigned char, N>
+      make_bb_prbs()
+      {
+        const_table<unsigned char, N> t = {};
+        int sr = 0x4A80;
+
+        for (int i = 0; i < N; i++) {
+          int b = ((sr) ^ (sr >> 1)) & 1;
+          t.v[i] = b;
+          sr >>= 1;
+          if (b) {
+            sr |= 0x4000;
+          }
+        }
+        return t;
+      }
+
+      constexpr const_table<unsigned char, PILOT_PRBS_LENGTH>
+      make_pilot_prbs()
+      {
+        const_table<unsigned char, PILOT_PRBS_LENGTH> t = {};
+        int sr = 0x7ff;
+
+        for (int i = 0; i < PILOT_PRBS_LENGTH; i++) {
+          int b = ((sr) ^ (sr >> 2)) & 1;
+          t.v[i] = sr & 1;
+          sr >>= 1;
+          if (b) {
+            sr |= 0x400;
+          }
+        }
+        return t;
+      }
+
+      constexpr const_table<int, P1_RANDOMIZE_LENGTH>
+      make_p1_randomize()
+      {
+        const_table<int, P1_RANDOMIZE_LENGTH> t = {};
+        int sr = 0x4e46;
+
+        for (int i = 0; i < P1_RANDOMIZE_LENGTH; i++) {
+          int b = ((sr) ^ (sr >> 1)) & 1;
+          t.v[i] = b ? -1 : 1;
+          sr >>= 1;
+          if (b) {
+            sr |= 0x4000;
+          }
+        }
+        return t;
+      }
+
+      /* Minimal polynomials of the BCH codes, lowest power first */
+      constexpr unsigned char polyn[12][17] = {
+        {1,0,1,1,0,1,0,0,0,0,0,0,0,0,0,0,1},
+        {1,1,0,0,1,1,1,0,1,0,0,0,0,0,0,0,1},
+        {1,0,1,1,1,1,0,1,1,1,1,1,0,0,0,0,1},
+        {1,0,1,0,1,0,1,0,0,1,0,1,1,0,1,0,1},
+        {1,1,1,1,0,1,0,0,1,1,1,1,1,0,0,0,1},
+        {1,0,1,0,1,1,0,1,1,1,1,0,1,1,1,1,1},
+        {1,0,1,0,0,1,1,0,1,1,1,1,0,1,0,1,1},
+        {1,1,1,0,0,1,1,0,1,1,0,0,1,1,1,0,1},
+        {1,0,0,0,0,1,0,1,0,1,1,1,0,0,0,0,1},
+        {1,1,1,0,0,1,0,1,1,0,1,0,1,1,1,0,1},
+        {1,0,1,1,0,1,0,0,0,1,0,1,1,1,0,0,1},
+        {1,1,0,0,0,1,1,1,0,1,0,1,1,0,0,0,1}
+      };
+
+      constexpr unsigned char polys[12][15] = {
+        {1,1,0,1,0,1,0,0,0,0,0,0,0,0,1},
+        {1,0,0,0,0,0,1,0,1,0,0,1,0,0,1},
+        {1,1,1,0,0,0,1,0,0,1,1,0,0,0,1},
+        {1,0,0,0,1,0,0,1,1,0,1,0,1,0,1},
+        {1,0,1,0,1,0,1,0,1,1,0,1,0,1,1},
+        {1,0,0,1,0,0,0,1,1,1,0,0,0,1,1},
+        {1,0,1,0,0,1,1,1,0,0,1,1,0,1,1},
+        {1,0,0,0,0,1,0,0,1,1,1,1,0,0,1},
+        {1,1,1,1,0,0,0,0,0,1,1,0,0,0,1},
+        {1,0,0,1,0,0,1,0,0,1,0,1,1,0,1},
+        {1,0,0,0,1,0,0,0,0,0,0,1,1,0,1},
+        {1,1,1,1,0,1,1,1,1,0,1,0,0,1,1}
+      };
+
+      /*
+       * Product over GF(2) of the first count minimal polynomials of
+       * degree M. The result has degree count * M, so N = count * M + 1.
+       */
+      template <int N, int M>
+      constexpr const_table<unsigned char, N>
+      make_bch_poly(const unsigned char (*minimal)[M + 1], int count)
+      {
+        const_table<unsigned char, N> t = {};
+        unsigned char prod[N] = {};
+        int len = 1;
+
+        t.v[0] = 1;
+        for (int p = 0; p < count; p++) {
+          for (int i = 0; i < len + M; i++) {
+            prod[i] = 0;
+          }
+          for (int i = 0; i < len; i++) {
+            for (int j = 0; j <= M; j++) {
+              prod[i + j] ^= t.v[i] & minimal[p][j];
+            }
+          }
+          len += M;
+          for (int i = 0; i < len; i++) {
+            t.v[i] = prod[i];
+          }
+        }
+        return t;
+      }
+
+    } // anonymous namespace
+
+    constexpr const_table<unsigned char, FRAME_SIZE_NORMAL> bb_prbs = make_bb_prbs<FRAME_SIZE_NORMAL>();
+    constexpr const_table<unsigned char, PILOT_PRBS_LENGTH> pilot_prbs = make_pilot_prbs();
+    constexpr const_table<int, P1_RANDOMIZE_LENGTH> p1_randomize = make_p1_randomize();
+    constexpr const_table<unsigned char, 129> bch_poly_n8 = make_bch_poly<129, 16>(polyn, 8);
+    constexpr const_table<unsigned char, 161> bch_poly_n10 = make_bch_poly<161, 16>(polyn, 10);
+    constexpr const_table<unsigned char, 193> bch_poly_n12 = make_bch_poly<193, 16>(polyn, 12);
+    constexpr const_table<unsigned char, 169> bch_poly_s12 = make_bch_poly<169, 14>(polys, 12);
+
+    static_assert(bb_prbs[BB_PRBS_PERIOD] == bb_prbs[0] && bb_prbs[BB_PRBS_PERIOD + 1] == bb_prbs[1], "BB scrambler period");
+    static_assert(bch_poly_n12[192] == 1 && bch_poly_s12[168] == 1, "BCH generator degree");
+
+  } // namespace dvbt2ll
+} // namespace gr
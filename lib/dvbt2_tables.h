@@ -0,0 +1,65 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2017 Ron Economos.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_DVBT2LL_DVBT2_TABLES_H
+#define INCLUDED_DVBT2LL_DVBT2_TABLES_H
+
+#include <dvbt2ll/dvbt2ll_config.h>
+
+#define BB_PRBS_PERIOD 32767
+#define PILOT_PRBS_LENGTH 27841
+#define P1_RANDOMIZE_LENGTH 384
+
+namespace gr {
+  namespace dvbt2ll {
+
+    /*
+     * Fixed sequences and polynomials of EN 302 755, generated by the
+     * compiler (see dvbt2_tables.cc) so they live in read-only data
+     * and cost nothing at block construction.
+     */
+    template <class T, int N>
+    struct const_table
+    {
+      T v[N];
+
+      constexpr const T &operator[](int i) const { return v[i]; }
+    };
+
+    /* 1 + x^14 + x^15 scrambler (5.2.2), used for the BB frames, the
+     * L1-post and the dummy cells. It repeats every BB_PRBS_PERIOD bits. */
+    extern const const_table<unsigned char, FRAME_SIZE_NORMAL> bb_prbs;
+
+    /* 1 + x^2 + x^11 reference sequence of the pilots (9.2.2) */
+    extern const const_table<unsigned char, PILOT_PRBS_LENGTH> pilot_prbs;
+
+    /* P1 carrier scrambling sequence (9.8) as +1/-1 */
+    extern const const_table<int, P1_RANDOMIZE_LENGTH> p1_randomize;
+
+    /* BCH generator polynomials (5.3.1), lowest power first */
+    extern const const_table<unsigned char, 129> bch_poly_n8;
+    extern const const_table<unsigned char, 161> bch_poly_n10;
+    extern const const_table<unsigned char, 193> bch_poly_n12;
+    extern const const_table<unsigned char, 169> bch_poly_s12;
+
+  } // namespace dvbt2ll
+} // namespace gr
+
+#endif /* INCLUDED_DVBT2LL_DVBT2_TABLES_H */
@@ -0,0 +1,226 @@
+/* -*- c++ -*- */
+/* 
+ * Copyright 2017 Ron Economos.
+ * 
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ * 
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "frame_buffer.h"
+#include <gnuradio/logger.h>
+#include <boost/atomic.hpp>
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+
+namespace gr {
+  namespace dvbt2ll {
+
+    enum hugepage_mode_t {
+      HUGEPAGES_OFF = 0,
+      HUGEPAGES_THP,
+      HUGEPAGES_EXPLICIT
+    };
+
+    /* In the FRAME_BUFFER_ALIGN bytes in front of every buffer */
+    struct buffer_header
+    {
+      char *base;
+      size_t length;    /* of the mapping, 0 if from posix_memalign() */
+    };
+
+    /* From linux/mempolicy.h, so libnuma isn't needed */
+    static const int mpol_preferred = 1;
+    static const unsigned int mpol_mf_move = 1 << 1;
+
+    static boost::atomic<bool> hugetlb_warned(false);
+
+    static hugepage_mode_t
+    read_hugepage_mode(void)
+    {
+      const char *env = getenv(FRAME_BUFFER_HUGEPAGES_ENV);
+
+      if (env == NULL || *env == '\0' || strcasecmp(env, "thp") == 0) {
+        return HUGEPAGES_THP;
+      }
+      if (strcasecmp(env, "off") == 0) {
+        return HUGEPAGES_OFF;
+      }
+      if (strcasecmp(env, "explicit") == 0) {
+        return HUGEPAGES_EXPLICIT;
+      }
+      GR_LOG_GETLOGGER(logger, "dvbt2ll");
+      GR_LOG_WARN(logger, std::string("DVB-T2LL, unknown ") + FRAME_BUFFER_HUGEPAGES_ENV + "=" + env + " ignored.");
+      return HUGEPAGES_THP;
+    }
+
+    static hugepage_mode_t
+    hugepage_mode(void)
+    {
+      static const hugepage_mode_t mode = read_hugepage_mode();
+
+      return mode;
+    }
+
+    /*
+     * length bytes on a HUGE_PAGE_SIZE boundary, length is a multiple
+     * of HUGE_PAGE_SIZE. The mapping is made one huge page longer and
+     * trimmed to the boundary.
+     */
+    static char *
+    map_huge(size_t length)
+    {
+      void *mapped;
+      char *base;
+      size_t head;
+
+#ifdef MAP_HUGETLB
+      if (hugepage_mode() == HUGEPAGES_EXPLICIT) {
+        mapped = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (mapped != MAP_FAILED) {
+          return (char *)mapped;
+        }
+        if (!hugetlb_warned.exchange(true)) {
+          GR_LOG_GETLOGGER(logger, "dvbt2ll");
+          GR_LOG_WARN(logger, "DVB-T2LL, not enough free huge pages, using transparent huge pages.");
+        }
+      }
+#endif
+      mapped = mmap(NULL, length + HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      if (mapped == MAP_FAILED) {
+        return NULL;
+      }
+      base = (char *)mapped;
+      head = (HUGE_PAGE_SIZE - ((uintptr_t)base % HUGE_PAGE_SIZE)) % HUGE_PAGE_SIZE;
+      if (head > 0) {
+        munmap(base, head);
+      }
+      munmap(base + head + length, HUGE_PAGE_SIZE - head);
+      base += head;
+#if defined(MADV_HUGEPAGE) && defined(MADV_NOHUGEPAGE)
+      madvise(base, length, hugepage_mode() == HUGEPAGES_OFF ? MADV_NOHUGEPAGE : MADV_HUGEPAGE);
+#endif
+      return base;
+    }
+
+    static inline buffer_header *
+    header_of(void *buffer)
+    {
+      return (buffer_header *)((char *)buffer - FRAME_BUFFER_ALIGN);
+    }
+
+    void *
+    frame_buffer_alloc(size_t bytes)
+    {
+      size_t total = bytes + FRAME_BUFFER_ALIGN;
+      size_t length = 0;
+      void *base;
+      buffer_header *header;
+
+      if (bytes >= HUGE_PAGE_SIZE) {
+        length = ((total + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE) * HUGE_PAGE_SIZE;
+        base = map_huge(length);
+        if (base == NULL) {
+          return NULL;
+        }
+      }
+      else if (posix_memalign(&base, FRAME_BUFFER_ALIGN, total) != 0) {
+        return NULL;
+      }
+      header = (buffer_header *)base;
+      header->base = (char *)base;
+      header->length = length;
+      return (char *)base + FRAME_BUFFER_ALIGN;
+    }
+
+    void
+    frame_buffer_free(void *buffer)
+    {
+      buffer_header *header;
+
+      if (buffer == NULL) {
+        return;
+      }
+      header = header_of(buffer);
+      if (header->length > 0) {
+        munmap(header->base, header->length);
+      }
+      else {
+        free(header->base);
+      }
+    }
+
+    /* The NUMA node of cpu, from sysfs, or -1 */
+    static int
+    cpu_node(int cpu)
+    {
+      char path[64];
+      DIR *dir;
+      struct dirent *entry;
+      int node = -1;
+
+      snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d", cpu);
+      dir = opendir(path);
+      if (dir == NULL) {
+        return -1;
+      }
+      while ((entry = readdir(dir)) != NULL) {
+        if (sscanf(entry->d_name, "node%d", &node) == 1) {
+          break;
+        }
+        node = -1;
+      }
+      closedir(dir);
+      return node;
+    }
+
+    bool
+    frame_buffer_place(void *buffer, int cpu)
+    {
+#if defined(__linux__) && defined(SYS_mbind)
+      const int bits = 8 * sizeof(unsigned long);
+      buffer_header *header;
+      int node = cpu_node(cpu);
+
+      if (buffer == NULL || node < 0) {
+        return false;
+      }
+      header = header_of(buffer);
+      if (header->length == 0) {
+        return false;
+      }
+      std::vector<unsigned long> nodemask((node / bits) + 1, 0);
+      nodemask[node / bits] = 1UL << (node % bits);
+      return syscall(SYS_mbind, header->base, header->length, mpol_preferred, &nodemask[0], nodemask.size() * bits + 1, mpol_mf_move) == 0;
+#else
+      return false;
+#endif
+    }
+
+  } /* namespace dvbt2ll */
+} /* namespace gr */
@@ -0,0 +1,87 @@
+/* -*- c++ -*- */
+/* 
+ * Copyright 2017 Ron Economos.
+ * 
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ * 
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_DVBT2LL_FRAME_BUFFER_H
+#define INCLUDED_DVBT2LL_FRAME_BUFFER_H
+
+#include <dvbt2ll/api.h>
+#include <cstddef>
+#include <new>
+
+/* Cache line, and the widest SIMD load (AVX-512) */
+#define FRAME_BUFFER_ALIGN 64
+#define HUGE_PAGE_SIZE (2 * 1024 * 1024)
+/* off, thp (the default) or explicit, for the buffers of a huge page or more */
+#define FRAME_BUFFER_HUGEPAGES_ENV "DVBT2LL_HUGEPAGES"
+
+namespace gr {
+  namespace dvbt2ll {
+
+    /*
+     * Buffers that are swept every T2 frame. They start on a
+     * FRAME_BUFFER_ALIGN boundary, and the ones of HUGE_PAGE_SIZE or
+     * more are mapped on their own, aligned to HUGE_PAGE_SIZE and
+     * backed by transparent huge pages (or by the hugetlbfs pool with
+     * DVBT2LL_HUGEPAGES=explicit, if it has enough free pages) to
+     * keep the TLB misses down. Returns NULL like malloc().
+     */
+    DVBT2LL_CORE_API void *frame_buffer_alloc(size_t bytes);
+    DVBT2LL_CORE_API void frame_buffer_free(void *buffer);
+
+    /*
+     * Moves the pages of a buffer of HUGE_PAGE_SIZE or more to the NUMA
+     * node of cpu, and keeps new ones there. For threads pinned to a
+     * CPU, on the buffers they write. Returns false if the buffer is
+     * smaller or the kernel refuses.
+     */
+    DVBT2LL_CORE_API bool frame_buffer_place(void *buffer, int cpu);
+
+    /* frame_buffer_alloc() for std::vector */
+    template <class T>
+    struct frame_allocator
+    {
+      typedef T value_type;
+
+      frame_allocator() {}
+      template <class U> frame_allocator(const frame_allocator<U> &) {}
+
+      T *allocate(size_t n)
+      {
+        void *p = frame_buffer_alloc(n * sizeof(T));
+
+        if (p == NULL) {
+          throw std::bad_alloc();
+        }
+        return static_cast<T *>(p);
+      }
+
+      void deallocate(T *p, size_t) { frame_buffer_free(p); }
+    };
+
+    template <class T, class U>
+    bool operator==(const frame_allocator<T> &, const frame_allocator<U> &) { return true; }
+
+    template <class T, class U>
+    bool operator!=(const frame_allocator<T> &, const frame_allocator<U> &) { return false; }
+
+  } // namespace dvbt2ll
+} // namespace gr
+
+#endif /* INCLUDED_DVBT2LL_FRAME_BUFFER_H */
@@ -0,0 +1,2235 @@
+/* -*- c++ -*- */
+/* 
+ * Copyright 2017 Ron Economos.
+ * 
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ * 
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "frame_mapper_impl.h"
+#include "sc16_cells.h"
+#include <algorithm>
+#include <cmath>
+
+namespace gr {
+  namespace dvbt2ll {
+
+    frame_mapper::sptr
+    frame_mapper::make(dvbt2_framesize_t framesize, dvbt2_code_rate_t rate, dvbt2_constellation_t constellation, dvbt2_rotation_t rotation, int fecblocks, int tiblocks, dvbt2_extended_carrier_t carriermode, dvbt2_fftsize_t fftsize, dvbt2_guardinterval_t guardinterval, dvbt2_l1constellation_t l1constellation, dvbt2_pilotpattern_t pilotpattern, int t2frames, int numdatasyms, dvbt2_papr_t paprmode, dvbt2_version_t version, dvbt2_preamble_t preamble, dvbt2_inputmode_t inputmode, dvbt2_reservedbiasbits_t reservedbiasbits, dvbt2_l1scrambled_t l1scrambled, dvbt2_inband_t inband)
+    {
+      return frame_mapper::sptr(new frame_mapper_impl(framesize, rate, constellation, rotation, fecblocks, tiblocks, carriermode, fftsize, guardinterval, l1constellation, pilotpattern, t2frames, numdatasyms, paprmode, version, preamble, inputmode, reservedbiasbits, l1scrambled, inband));
+    }
+
+    table_cache<frame_mapper_impl::fi_key, frame_mapper_impl::fi_tables> frame_mapper_impl::fi_cache;
+    table_cache<frame_mapper_impl::frame_map_key, frame_mapper_impl::frame_map_t> frame_mapper_impl::frame_map_cache;
+
+    frame_mapper_impl::frame_mapper_impl(dvbt2_framesize_t framesize, dvbt2_code_rate_t rate, dvbt2_constellation_t constellation, dvbt2_rotation_t rotation, int fecblocks, int tiblocks, dvbt2_extended_carrier_t carriermode, dvbt2_fftsize_t fftsize, dvbt2_guardinterval_t guardinterval, dvbt2_l1constellation_t l1constellation, dvbt2_pilotpattern_t pilotpattern, int t2frames, int numdatasyms, dvbt2_papr_t paprmode, dvbt2_version_t version, dvbt2_preamble_t preamble, dvbt2_inputmode_t inputmode, dvbt2_reservedbiasbits_t reservedbiasbits, dvbt2_l1scrambled_t l1scrambled, dvbt2_inband_t inband)
+    {
+      L1Pre *l1preinit;
+      L1Post *l1postinit;
+      double normalization;
+      double m_16qam_lookup[4] = {3.0, 1.0, -3.0, -1.0};
+      double m_64qam_lookup[8] = {7.0, 5.0, 1.0, 3.0, -7.0, -5.0, -1.0, -3.0};
+      int real_index, imag_index;
+      cfg = boost::shared_ptr<frame_config>(new frame_config);
+      l1preinit = &cfg->L1_Signalling[0].l1pre_data;
+      l1postinit = &cfg->L1_Signalling[0].l1post_data;
+      l1preinit->type = STREAMTYPE_TS;
+      l1preinit->bwt_ext = carriermode;
+      fft_size = fftsize;
+      l1preinit->s1 = preamble;
+      l1preinit->s2 = fft_size & 0x7;
+      l1preinit->l1_repetition_flag = FALSE;
+      l1preinit->guard_interval = guardinterval;
+      l1preinit->papr = paprmode;
+      l1preinit->l1_cod = 0;
+      l1preinit->l1_fec_type = 0;
+      l1preinit->l1_post_info_size = KSIG_POST - 32;
+      l1preinit->pilot_pattern = pilotpattern;
+      l1preinit->tx_id_availability = 0;
+      l1preinit->cell_id = 0;
+      l1preinit->network_id = 0x3085;
+      l1preinit->t2_system_id = 0x8001;
+      l1preinit->num_data_symbols = numdatasyms;
+      l1preinit->regen_flag = FALSE;
+      l1preinit->l1_post_extension = FALSE;
+      l1preinit->num_rf = 1;
+      l1preinit->current_rf_index = 0;
+      l1preinit->t2_version = version;
+      if (version == VERSION_131) {
+        l1preinit->l1_post_scrambled = l1scrambled;
+      }
+      else {
+        l1preinit->l1_post_scrambled = FALSE;
+      }
+      l1preinit->t2_base_lite = FALSE;
+      if (reservedbiasbits == RESERVED_ON && version == VERSION_131) {
+        l1preinit->reserved = 0xf;
+      }
+      else {
+        l1preinit->reserved = 0x0;
+      }
+
+      l1postinit->sub_slices_per_frame = 1;
+      l1postinit->num_plp = 1;
+      l1postinit->num_aux = 0;
+      l1postinit->aux_config_rfu = 0;
+      l1postinit->rf_idx = 0;
+      l1postinit->frequency = 729833333;
+      l1postinit->plp_id = 0;
+      l1postinit->plp_type = 1;
+      l1postinit->plp_payload_type = 3;
+      l1postinit->ff_flag = 0;
+      l1postinit->first_rf_idx = 0;
+      l1postinit->first_frame_idx = 0;
+      l1postinit->plp_group_id = 1;
+      switch (rate) {
+        case C1_3:
+          l1postinit->plp_cod = 6;
+          break;
+        case C2_5:
+          l1postinit->plp_cod = 7;
+          break;
+        case C1_2:
+          l1postinit->plp_cod = 0;
+          break;
+        case C3_5:
+          l1postinit->plp_cod = 1;
+          break;
+        case C2_3:
+          l1postinit->plp_cod = 2;
+          break;
+        case C3_4:
+          l1postinit->plp_cod = 3;
+          break;
+        case C4_5:
+          l1postinit->plp_cod = 4;
+          break;
+        case C5_6:
+          l1postinit->plp_cod = 5;
+          break;
+        default:
+          l1postinit->plp_cod = 0;
+          break;
+      }
+      l1postinit->plp_fec_type = framesize;
+      l1postinit->frame_interval = 1;
+      l1postinit->time_il_type = 0;
+      l1postinit->in_band_a_flag = 0;
+      if (inband == INBAND_ON && version == VERSION_131) {
+        l1postinit->in_band_b_flag = 1;
+      }
+      else {
+        l1postinit->in_band_b_flag = 0;
+      }
+      if (reservedbiasbits == RESERVED_ON && version == VERSION_131) {
+        l1postinit->reserved_1 = 0x7ff;
+      }
+      else {
+        l1postinit->reserved_1 = 0x0;
+      }
+      if (version == VERSION_111) {
+        l1postinit->plp_mode = 0;
+      }
+      else {
+        l1postinit->plp_mode = inputmode + 1;
+      }
+      l1postinit->static_flag = 0;
+      l1postinit->static_padding_flag = 0;
+      l1postinit->fef_length_msb = 0;
+      if (reservedbiasbits == RESERVED_ON && version == VERSION_131) {
+        l1postinit->reserved_2 = 0x3fffffff;
+      }
+      else {
+        l1postinit->reserved_2 = 0;
+      }
+      l1postinit->frame_idx = 0;
+      l1postinit->sub_slice_interval = 0;
+      l1postinit->type_2_start = 0;
+      l1postinit->l1_change_counter = 0;
+      l1postinit->start_rf_idx = 0;
+      if (reservedbiasbits == RESERVED_ON && version == VERSION_131) {
+        l1postinit->reserved_3 = 0xff;
+      }
+      else {
+        l1postinit->reserved_3 = 0;
+      }
+      l1postinit->plp_id_dynamic = 0;
+      l1postinit->plp_start = 0;
+      if (reservedbiasbits == RESERVED_ON && version == VERSION_131) {
+        l1postinit->reserved_4 = 0xff;
+        l1postinit->reserved_5 = 0xff;
+      }
+      else {
+        l1postinit->reserved_4 = 0;
+        l1postinit->reserved_5 = 0;
+      }
+
+      l1_bch.init(bch_poly_s12.v, NBCH_PARITY);
+      m_bpsk[0] = gr_complex( 1.0,  0.0);
+      m_bpsk[1] = gr_complex( -1.0,  0.0);
+      unmodulated = gr_complex( 0.0,  0.0);
+
+      /* all L1 constellations, the L1-post one can change at run time */
+      normalization = sqrt(2);
+      m_qpsk[0] = gr_complex( 1.0 / normalization,  1.0 / normalization);
+      m_qpsk[1] = gr_complex( 1.0 / normalization, -1.0 / normalization);
+      m_qpsk[2] = gr_complex(-1.0 / normalization,  1.0 / normalization);
+      m_qpsk[3] = gr_complex(-1.0 / normalization, -1.0 / normalization);
+      normalization = sqrt(10);
+      for (int i = 0; i < 16; i++) {
+        real_index = ((i & 0x8) >> 2) | ((i & 0x2) >> 1);
+        imag_index = ((i & 0x4) >> 1) | ((i & 0x1) >> 0);
+        m_16qam[i] = gr_complex(m_16qam_lookup[real_index] / normalization, m_16qam_lookup[imag_index] / normalization);
+      }
+      normalization = sqrt(42);
+      for (int i = 0; i < 64; i++) {
+        real_index = ((i & 0x20) >> 3) | ((i & 0x8) >> 2) | ((i & 0x2) >> 1);
+        imag_index = ((i & 0x10) >> 2) | ((i & 0x4) >> 1) | ((i & 0x1) >> 0);
+        m_64qam[i] = gr_complex(m_64qam_lookup[real_index] / normalization, m_64qam_lookup[imag_index] / normalization);
+      }
+      N_P2 = 1;
+      C_P2 = 0;
+      N_FC = 0;
+      C_FC = 0;
+      C_DATA = 0;
+      if ((preamble == PREAMBLE_T2_SISO) || (preamble == PREAMBLE_T2_LITE_SISO)) {
+        switch (fft_size) {
+          case FFTSIZE_1K:
+            N_P2 = 16;
+            C_P2 = 558;
+            break;
+          case FFTSIZE_2K:
+            N_P2 = 8;
+            C_P2 = 1118;
+            break;
+          case FFTSIZE_4K:
+            N_P2 = 4;
+            C_P2 = 2236;
+            break;
+          case FFTSIZE_8K:
+          case FFTSIZE_8K_T2GI:
+            N_P2 = 2;
+            C_P2 = 4472;
+            break;
+          case FFTSIZE_16K:
+          case FFTSIZE_16K_T2GI:
+            N_P2 = 1;
+            C_P2 = 8944;
+            break;
+          case FFTSIZE_32K:
+          case FFTSIZE_32K_T2GI:
+            N_P2 = 1;
+            C_P2 = 22432;
+            break;
+        }
+      }
+      else {
+        switch (fft_size) {
+          case FFTSIZE_1K:
+            N_P2 = 16;
+            C_P2 = 546;
+            break;
+          case FFTSIZE_2K:
+            N_P2 = 8;
+            C_P2 = 1098;
+            break;
+          case FFTSIZE_4K:
+            N_P2 = 4;
+            C_P2 = 2198;
+            break;
+          case FFTSIZE_8K:
+          case FFTSIZE_8K_T2GI:
+            N_P2 = 2;
+            C_P2 = 4398;
+            break;
+          case FFTSIZE_16K:
+          case FFTSIZE_16K_T2GI:
+            N_P2 = 1;
+            C_P2 = 8814;
+            break;
+          case FFTSIZE_32K:
+          case FFTSIZE_32K_T2GI:
+            N_P2 = 1;
+            C_P2 = 17612;
+            break;
+        }
+      }
+      switch (fft_size) {
+        case FFTSIZE_1K:
+          switch (pilotpattern) {
+            case PILOT_PP1:
+              C_DATA = 764;
+              N_FC = 568;
+              C_FC = 402;
+              break;
+            case PILOT_PP2:
+              C_DATA = 768;
+              N_FC = 710;
+              C_FC = 654;
+              break;
+            case PILOT_PP3:
+              C_DATA = 798;
+              N_FC = 710;
+              C_FC = 490;
+              break;
+            case PILOT_PP4:
+              C_DATA = 804;
+              N_FC = 780;
+              C_FC = 707;
+              break;
+            case PILOT_PP5:
+              C_DATA = 818;
+              N_FC = 780;
+              C_FC = 544;
+              break;
+            case PILOT_PP6:
+              C_DATA = 0;
+              N_FC = 0;
+              C_FC = 0;
+              break;
+            case PILOT_PP7:
+              C_DATA = 0;
+              N_FC = 0;
+              C_FC = 0;
+              break;
+            case PILOT_PP8:
+              C_DATA = 0;
+              N_FC = 0;
+              C_FC = 0;
+              break;
+          }
+          if (paprmode == PAPR_TR || paprmode == PAPR_BOTH) {
+            if (C_DATA != 0) {
+              C_DATA -= 10;
+            }
+            if (N_FC != 0) {
+              N_FC -= 10;
+            }
+            if (C_FC != 0) {
+              C_FC -= 10;
+            }
+          }
+          break;
+        case FFTSIZE_2K:
+          switch (pilotpattern) {
+            case PILOT_PP1:
+              C_DATA = 1522;
+              N_FC = 1136;
+              C_FC = 804;
+              break;
+            case PILOT_PP2:
+              C_DATA = 1532;
+              N_FC = 1420;
+              C_FC = 1309;
+              break;
+            case PILOT_PP3:
+              C_DATA = 1596;
+              N_FC = 1420;
+              C_FC = 980;
+              break;
+            case PILOT_PP4:
+              C_DATA = 1602;
+              N_FC = 1562;
+              C_FC = 1415;
+              break;
+            case PILOT_PP5:
+              C_DATA = 1632;
+              N_FC = 1562;
+              C_FC = 1088;
+              break;
+            case PILOT_PP6:
+              C_DATA = 0;
+              N_FC = 0;
+              C_FC = 0;
+              break;
+            case PILOT_PP7:
+              C_DATA = 1646;
+              N_FC = 1632;
+              C_FC = 1396;
+              break;
+            case PILOT_PP8:
+              C_DATA = 0;
+              N_FC = 0;
+              C_FC = 0;
+              break;
+          }
+          if (paprmode == PAPR_TR || paprmode == PAPR_BOTH) {
+            if (C_DATA != 0) {
+              C_DATA -= 18;
+            }
+            if (N_FC != 0) {
+              N_FC -= 18;
+            }
+            if (C_FC != 0) {
+              C_FC -= 18;
+            }
+          }
+          break;
+        case FFTSIZE_4K:
+          switch (pilotpattern) {
+            case PILOT_PP1:
+              C_DATA = 3084;
+              N_FC = 2272;
+              C_FC = 1609;
+              break;
+            case PILOT_PP2:
+              C_DATA = 3092;
+              N_FC = 2840;
+              C_FC = 2619;
+              break;
+            case PILOT_PP3:
+              C_DATA = 3228;
+              N_FC = 2840;
+              C_FC = 1961;
+              break;
+            case PILOT_PP4:
+              C_DATA = 3234;
+              N_FC = 3124;
+              C_FC = 2831;
+              break;
+            case PILOT_PP5:
+              C_DATA = 3298;
+              N_FC = 3124;
+              C_FC = 2177;
+              break;
+            case PILOT_PP6:
+              C_DATA = 0;
+              N_FC = 0;
+              C_FC = 0;
+              break;
+            case PILOT_PP7:
+              C_DATA = 3328;
+              N_FC = 3266;
+              C_FC = 2792;
+              break;
+            case PILOT_PP8:
+              C_DATA = 0;
+              N_FC = 0;
+              C_FC = 0;
+              break;
+          }
+          if (paprmode == PAPR_TR || paprmode == PAPR_BOTH) {
+            if (C_DATA != 0) {
+              C_DATA -= 36;
+            }
+            if (N_FC != 0) {
+              N_FC -= 36;
+            }
+            if (C_FC != 0) {
+              C_FC -= 36;
+            }
+          }
+          break;
+        case FFTSIZE_8K:
+        case FFTSIZE_8K_T2GI:
+          if (carriermode == CARRIERS_NORMAL) {
+            switch (pilotpattern) {
+              case PILOT_PP1:
+                C_DATA = 6208;
+                N_FC = 4544;
+                C_FC = 3218;
+                break;
+              case PILOT_PP2:
+                C_DATA = 6214;
+                N_FC = 5680;
+                C_FC = 5238;
+                break;
+              case PILOT_PP3:
+                C_DATA = 6494;
+                N_FC = 5680;
+                C_FC = 3922;
+                break;
+              case PILOT_PP4:
+                C_DATA = 6498;
+                N_FC = 6248;
+                C_FC = 5662;
+                break;
+              case PILOT_PP5:
+                C_DATA = 6634;
+                N_FC = 6248;
+                C_FC = 4354;
+                break;
+              case PILOT_PP6:
+                C_DATA = 0;
+                N_FC = 0;
+                C_FC = 0;
+                break;
+              case PILOT_PP7:
+                C_DATA = 6698;
+                N_FC = 6532;
+                C_FC = 5585;
+                break;
+              case PILOT_PP8:
+                C_DATA = 6698;
+                N_FC = 0;
+                C_FC = 0;
+                break;
+            }
+          }
+          else {
+            switch (pilotpattern) {
+              case PILOT_PP1:
+                C_DATA = 6296;
+                N_FC = 4608;
+                C_FC = 3264;
+                break;
+              case PILOT_PP2:
+                C_DATA = 6298;
+                N_FC = 5760;
+                C_FC = 5312;
+                break;
+              case PILOT_PP3:
+                C_DATA = 6584;
+                N_FC = 5760;
+                C_FC = 3978;
+                break;
+              case PILOT_PP4:
+                C_DATA = 6588;
+                N_FC = 6336;
+                C_FC = 5742;
+                break;
+              case PILOT_PP5:
+                C_DATA = 6728;
+                N_FC = 6336;
+                C_FC = 4416;
+                break;
+              case PILOT_PP6:
+                C_DATA = 0;
+                N_FC = 0;
+                C_FC = 0;
+                break;
+              case PILOT_PP7:
+                C_DATA = 6788;
+                N_FC = 6624;
+                C_FC = 5664;
+                break;
+              case PILOT_PP8:
+                C_DATA = 6788;
+                N_FC = 0;
+                C_FC = 0;
+                break;
+            }
+          }
+          if (paprmode == PAPR_TR || paprmode == PAPR_BOTH) {
+            if (C_DATA != 0) {
+              C_DATA -= 72;
+            }
+            if (N_FC != 0) {
+              N_FC -= 72;
+            }
+            if (C_FC != 0) {
+              C_FC -= 72;
+            }
+          }
+          break;
+        case FFTSIZE_16K:
+        case FFTSIZE_16K_T2GI:
+          if (carriermode == CARRIERS_NORMAL) {
+            switch (pilotpattern) {
+              case PILOT_PP1:
+                C_DATA = 12418;
+                N_FC = 9088;
+                C_FC = 6437;
+                break;
+              case PILOT_PP2:
+                C_DATA = 12436;
+                N_FC = 11360;
+                C_FC = 10476;
+                break;
+              case PILOT_PP3:
+                C_DATA = 12988;
+                N_FC = 11360;
+                C_FC = 7845;
+                break;
+              case PILOT_PP4:
+                C_DATA = 13002;
+                N_FC = 12496;
+                C_FC = 11324;
+                break;
+              case PILOT_PP5:
+                C_DATA = 13272;
+                N_FC = 12496;
+                C_FC = 8709;
+                break;
+              case PILOT_PP6:
+                C_DATA = 13288;
+                N_FC = 13064;
+                C_FC = 11801;
+                break;
+              case PILOT_PP7:
+                C_DATA = 13416;
+                N_FC = 13064;
+                C_FC = 11170;
+                break;
+              case PILOT_PP8:
+                C_DATA = 13406;
+                N_FC = 0;
+                C_FC = 0;
+                break;
+            }
+          }
+          else {
+            switch (pilotpattern) {
+              case PILOT_PP1:
+                C_DATA = 12678;
+                N_FC = 9280;
+                C_FC = 6573;
+                break;
+              case PILOT_PP2:
+                C_DATA = 12698;
+                N_FC = 11600;
+                C_FC = 10697;
+                break;
+              case PILOT_PP3:
+                C_DATA = 13262;
+                N_FC = 11600;
+                C_FC = 8011;
+                break;
+              case PILOT_PP4:
+                C_DATA = 13276;
+                N_FC = 12760;
+                C_FC = 11563;
+                break;
+              case PILOT_PP5:
+                C_DATA = 13552;
+                N_FC = 12760;
+                C_FC = 8893;
+                break;
+              case PILOT_PP6:
+                C_DATA = 13568;
+                N_FC = 13340;
+                C_FC = 12051;
+                break;
+              case PILOT_PP7:
+                C_DATA = 13698;
+                N_FC = 13340;
+                C_FC = 11406;
+                break;
+              case PILOT_PP8:
+                C_DATA = 13688;
+                N_FC = 0;
+                C_FC = 0;
+                break;
+            }
+          }
+          if (paprmode == PAPR_TR || paprmode == PAPR_BOTH) {
+            if (C_DATA != 0) {
+              C_DATA -= 144;
+            }
+            if (N_FC != 0) {
+              N_FC -= 144;
+            }
+            if (C_FC != 0) {
+              C_FC -= 144;
+            }
+          }
+          break;
+        case FFTSIZE_32K:
+        case FFTSIZE_32K_T2GI:
+          if (carriermode == CARRIERS_NORMAL) {
+            switch (pilotpattern) {
+              case PILOT_PP1:
+                C_DATA = 0;
+                N_FC = 0;
+                C_FC = 0;
+                break;
+              case PILOT_PP2:
+                C_DATA = 24886;
+                N_FC = 22720;
+                C_FC = 20952;
+                break;
+              case PILOT_PP3:
+                C_DATA = 0;
+                N_FC = 0;
+                C_FC = 0;
+                break;
+              case PILOT_PP4:
+                C_DATA = 26022;
+                N_FC = 24992;
+                C_FC = 22649;
+                break;
+              case PILOT_PP5:
+                C_DATA = 0;
+                N_FC = 0;
+                C_FC = 0;
+                break;
+              case PILOT_PP6:
+                C_DATA = 26592;
+                N_FC = 26128;
+                C_FC = 23603;
+                break;
+              case PILOT_PP7:
+                C_DATA = 26836;
+                N_FC = 0;
+                C_FC = 0;
+                break;
+              case PILOT_PP8:
+                C_DATA = 26812;
+                N_FC = 0;
+                C_FC = 0;
+                break;
+            }
+          }
+          else {
+            switch (pilotpattern) {
+              case PILOT_PP1:
+                C_DATA = 0;
+                N_FC = 0;
+                C_FC = 0;
+                break;
+              case PILOT_PP2:
+                C_DATA = 25412;
+                N_FC = 23200;
+                C_FC = 21395;
+                break;
+              case PILOT_PP3:
+                C_DATA = 0;
+                N_FC = 0;
+                C_FC = 0;
+                break;
+              case PILOT_PP4:
+                C_DATA = 26572;
+                N_FC = 25520;
+                C_FC = 23127;
+                break;
+              case PILOT_PP5:
+                C_DATA = 0;
+                N_FC = 0;
+                C_FC = 0;
+                break;
+              case PILOT_PP6:
+                C_DATA = 27152;
+                N_FC = 26680;
+                C_FC = 24102;
+                break;
+              case PILOT_PP7:
+                C_DATA = 27404;
+                N_FC = 0;
+                C_FC = 0;
+                break;
+              case PILOT_PP8:
+                C_DATA = 27376;
+                N_FC = 0;
+                C_FC = 0;
+                break;
+            }
+          }
+          if (paprmode == PAPR_TR || paprmode == PAPR_BOTH) {
+            if (C_DATA != 0) {
+              C_DATA -= 288;
+            }
+            if (N_FC != 0) {
+              N_FC -= 288;
+            }
+            if (C_FC != 0) {
+              C_FC -= 288;
+            }
+          }
+          break;
+      }
+      if ((preamble == PREAMBLE_T2_SISO) || (preamble == PREAMBLE_T2_LITE_SISO)) {
+        if (guardinterval == GI_1_128 && pilotpattern == PILOT_PP7) {
+          N_FC = 0;
+          C_FC = 0;
+        }
+        if (guardinterval == GI_1_32 && pilotpattern == PILOT_PP4) {
+          N_FC = 0;
+          C_FC = 0;
+        }
+        if (guardinterval == GI_1_16 && pilotpattern == PILOT_PP2) {
+          N_FC = 0;
+          C_FC = 0;
+        }
+        if (guardinterval == GI_19_256 && pilotpattern == PILOT_PP2) {
+          N_FC = 0;
+          C_FC = 0;
+        }
+      }
+      fi = fi_cache.get(fi_key(fftsize, C_P2, C_DATA, N_FC), boost::bind(&frame_mapper_impl::build_fi_tables, this, fftsize));
+      fec_frame = framesize;
+      t2_frame_num = 0;
+      if (version == VERSION_131) {
+        l1_scrambled = l1scrambled;
+      }
+      else {
+        l1_scrambled = FALSE;
+      }
+      setup_config(cfg.get(), constellation, rotation, fecblocks, tiblocks, l1constellation, t2frames);
+      if (N_FC == 0) {
+        mapped_items = (N_P2 * C_P2) + (numdatasyms * C_DATA);
+        num_data_symbols = numdatasyms;
+      }
+      else {
+        mapped_items = (N_P2 * C_P2) + ((numdatasyms - 1) * C_DATA) + N_FC;
+        num_data_symbols = numdatasyms - 1;
+      }
+      setup_fits = config_fits(cfg.get());
+      if (!setup_fits) {
+        mapped_items = cfg->stream_items + 1840 + (cfg->N_post / cfg->eta_mod) + (N_FC - C_FC);    /* avoid segfault */
+      }
+      total_symbols = N_P2 + num_data_symbols;
+      if (N_FC != 0) {
+        total_symbols++;
+      }
+      build_config(cfg.get());
+    }
+
+    frame_mapper_impl::~frame_mapper_impl()
+    {
+    }
+
+    /*
+     * Frequency interleaver permutations (8.5) for the FFT size, cut
+     * down to the P2, data and frame closing symbol cell counts.
+     */
+    frame_mapper_impl::fi_tables *
+    frame_mapper_impl::build_fi_tables(int fftsize)
+    {
+      int pn_degree, max_states, xor_size, pn_mask, result;
+      int q_even = 0;
+      int q_odd = 0;
+      int q_evenP2 = 0;
+      int q_oddP2 = 0;
+      int q_evenFC = 0;
+      int q_oddFC = 0;
+      int lfsr = 0;
+      int logic1k[2] = {0, 4};
+      int logic2k[2] = {0, 3};
+      int logic4k[2] = {0, 2};
+      int logic8k[4] = {0, 1, 4, 6};
+      int logic16k[6] = {0, 1, 4, 5, 9, 11};
+      int logic32k[4] = {0, 1, 2, 12};
+      int *logic;
+      const int *bitpermeven, *bitpermodd;
+      int even, odd;
+      fi_tables *tables;
+
+      switch (fftsize) {
+        case FFTSIZE_1K:
+          pn_degree = 9;
+          pn_mask = 0x1ff;
+          max_states = 1024;
+          logic = &logic1k[0];
+          xor_size = 2;
+          bitpermeven = &bitperm1keven[0];
+          bitpermodd = &bitperm1kodd[0];
+          break;
+        case FFTSIZE_2K:
+          pn_degree = 10;
+          pn_mask = 0x3ff;
+          max_states = 2048;
+          logic = &logic2k[0];
+          xor_size = 2;
+          bitpermeven = &bitperm2keven[0];
+          bitpermodd = &bitperm2kodd[0];
+          break;
+        case FFTSIZE_4K:
+          pn_degree = 11;
+          pn_mask = 0x7ff;
+          max_states = 4096;
+          logic = &logic4k[0];
+          xor_size = 2;
+          bitpermeven = &bitperm4keven[0];
+          bitpermodd = &bitperm4kodd[0];
+          break;
+        case FFTSIZE_8K:
+        case FFTSIZE_8K_T2GI:
+          pn_degree = 12;
+          pn_mask = 0xfff;
+          max_states = 8192;
+          logic = &logic8k[0];
+          xor_size = 4;
+          bitpermeven = &bitperm8keven[0];
+          bitpermodd = &bitperm8kodd[0];
+          break;
+        case FFTSIZE_16K:
+        case FFTSIZE_16K_T2GI:
+          pn_degree = 13;
+          pn_mask = 0x1fff;
+          max_states = 16384;
+          logic = &logic16k[0];
+          xor_size = 6;
+          bitpermeven = &bitperm16keven[0];
+          bitpermodd = &bitperm16kodd[0];
+          break;
+        case FFTSIZE_32K:
+        case FFTSIZE_32K_T2GI:
+          pn_degree = 14;
+          pn_mask = 0x3fff;
+          max_states = 32768;
+          logic = &logic32k[0];
+          xor_size = 4;
+          bitpermeven = &bitperm32k[0];
+          bitpermodd = &bitperm32k[0];
+          break;
+        default:
+          pn_degree = 0;
+          pn_mask = 0;
+          max_states = 0;
+          logic = &logic1k[0];
+          xor_size = 0;
+          bitpermeven = &bitperm1keven[0];
+          bitpermodd = &bitperm1kodd[0];
+          break;
+      }
+      tables = new fi_tables;
+      tables->Heven.resize(C_DATA);
+      tables->Hodd.resize(C_DATA);
+      tables->HevenP2.resize(C_P2);
+      tables->HoddP2.resize(C_P2);
+      tables->HevenFC.resize(N_FC);
+      tables->HoddFC.resize(N_FC);
+      for (int i = 0; i < max_states; i++) {
+        if (i == 0 || i == 1) {
+          lfsr = 0;
+        }
+        else if (i == 2) {
+          lfsr = 1;
+        }
+        else {
+          result = 0;
+          for (int k = 0; k < xor_size; k++) {
+            result ^= (lfsr >> logic[k]) & 1;
+          }
+          lfsr &= pn_mask;
+          lfsr >>= 1;
+          lfsr |= result << (pn_degree - 1);
+        }
+        even = 0;
+        odd = 0;
+        for (int n = 0; n < pn_degree; n++) {
+          even |= ((lfsr >> n) & 0x1) << bitpermeven[n];
+        }
+        for (int n = 0; n < pn_degree; n++) {
+          odd |= ((lfsr >> n) & 0x1) << bitpermodd[n];
+        }
+        even = even + ((i % 2) * (max_states / 2));
+        odd = odd + ((i % 2) * (max_states / 2));
+        if (even < C_DATA) {
+          tables->Heven[q_even++] = even;
+        }
+        if (odd < C_DATA) {
+          tables->Hodd[q_odd++] = odd;
+        }
+        if (even < C_P2) {
+          tables->HevenP2[q_evenP2++] = even;
+        }
+        if (odd < C_P2) {
+          tables->HoddP2[q_oddP2++] = odd;
+        }
+        if (even < N_FC) {
+          tables->HevenFC[q_evenFC++] = even;
+        }
+        if (odd < N_FC) {
+          tables->HoddFC[q_oddFC++] = odd;
+        }
+      }
+      if (fftsize == FFTSIZE_32K || fftsize == FFTSIZE_32K_T2GI) {
+        for (int j = 0; j < q_odd; j++) {
+          int a;
+          a = tables->Hodd[j];
+          tables->Heven[a] = j;
+        }
+        for (int j = 0; j < q_oddP2; j++) {
+          int a;
+          a = tables->HoddP2[j];
+          tables->HevenP2[a] = j;
+        }
+        for (int j = 0; j < q_oddFC; j++) {
+          int a;
+          a = tables->HoddFC[j];
+          tables->HevenFC[a] = j;
+        }
+      }
+      return tables;
+    }
+
+    /*
+     * Derives the run-time configurable part of the configuration,
+     * the L1 fields have to be filled in already.
+     */
+    void
+    frame_mapper_impl::setup_config(frame_config *fc, int constellation, int rotation, int fecblocks, int tiblocks, int l1constellation, int t2frames)
+    {
+      L1Pre *l1preinit = &fc->L1_Signalling[0].l1pre_data;
+      L1Post *l1postinit = &fc->L1_Signalling[0].l1post_data;
+      int N_punc_temp, N_post_temp;
+
+      fc->constellation = constellation;
+      fc->rotation = rotation;
+      fc->fec_blocks = fecblocks;
+      fc->ti_blocks = tiblocks;
+      fc->l1_constellation = l1constellation;
+      fc->t2_frames = t2frames;
+      if (fec_frame == FECFRAME_NORMAL) {
+        switch (constellation) {
+          case MOD_16QAM:
+            fc->cell_size = 16200;
+            break;
+          case MOD_64QAM:
+            fc->cell_size = 10800;
+            break;
+          case MOD_256QAM:
+            fc->cell_size = 8100;
+            break;
+          default:
+            fc->cell_size = 32400;
+            break;
+        }
+      }
+      else {
+        switch (constellation) {
+          case MOD_16QAM:
+            fc->cell_size = 4050;
+            break;
+          case MOD_64QAM:
+            fc->cell_size = 2700;
+            break;
+          case MOD_256QAM:
+            fc->cell_size = 2025;
+            break;
+          default:
+            fc->cell_size = 8100;
+            break;
+        }
+      }
+      switch (l1constellation) {
+        case L1_MOD_QPSK:
+          fc->eta_mod = 2;
+          break;
+        case L1_MOD_16QAM:
+          fc->eta_mod = 4;
+          break;
+        case L1_MOD_64QAM:
+          fc->eta_mod = 6;
+          break;
+        default:
+          fc->eta_mod = 1;
+          break;
+      }
+      N_punc_temp = (6 * (KBCH_1_2 - KSIG_POST)) / 5;
+      N_post_temp = KSIG_POST + NBCH_PARITY + 9000 - N_punc_temp;
+      if (N_P2 == 1) {
+        fc->N_post = ceil((float)N_post_temp / (2 * (float)fc->eta_mod)) * 2 * fc->eta_mod;
+      }
+      else {
+        fc->N_post = ceil((float)N_post_temp / ((float)fc->eta_mod * (float)N_P2)) * fc->eta_mod * N_P2;
+      }
+      fc->N_punc = N_punc_temp - (fc->N_post - N_post_temp);
+      if (tiblocks == 0) {
+        fc->FECBlocksPerSmallTIBlock = 1;
+        fc->FECBlocksPerBigTIBlock = 1;
+        fc->numBigTIBlocks = 0;
+        fc->numSmallTIBlocks = fecblocks;
+      }
+      else {
+        fc->FECBlocksPerSmallTIBlock = floor(((float)fecblocks) / ((float)tiblocks));
+        fc->FECBlocksPerBigTIBlock = ceil(((float)fecblocks) / ((float)tiblocks));
+        fc->numBigTIBlocks = fecblocks % tiblocks;
+        fc->numSmallTIBlocks = tiblocks - fc->numBigTIBlocks;
+      }
+      fc->stream_items = fc->cell_size * fecblocks;
+      l1preinit->l1_mod = l1constellation;
+      l1preinit->l1_post_size = fc->N_post / fc->eta_mod;
+      l1preinit->num_t2_frames = t2frames;
+      l1postinit->plp_mod = constellation;
+      l1postinit->plp_rotation = rotation;
+      l1postinit->plp_num_blocks_max = fecblocks;
+      l1postinit->time_il_length = tiblocks;
+      l1postinit->plp_num_blocks = fecblocks;
+    }
+
+    bool
+    frame_mapper_impl::config_fits(const frame_config *fc) const
+    {
+      return mapped_items >= fc->stream_items + 1840 + (fc->N_post / fc->eta_mod) + (N_FC - C_FC);
+    }
+
+    boost::shared_ptr<frame_mapper_impl::frame_config>
+    frame_mapper_impl::new_config(int constellation, int rotation, int fecblocks, int tiblocks, int l1constellation, int t2frames)
+    {
+      boost::shared_ptr<frame_config> fc(new frame_config);
+
+      fc->L1_Signalling[0] = cfg->L1_Signalling[0];
+      fc->L1_Signalling[0].l1post_data.l1_change_counter = 0;
+      setup_config(fc.get(), constellation, rotation, fecblocks, tiblocks, l1constellation, t2frames);
+      return fc;
+    }
+
+    /*
+     * Builds the L1 caches and looks up the frame map, which is shared
+     * by all instances with the same frame layout. Throws
+     * std::bad_alloc.
+     */
+    void
+    frame_mapper_impl::build_config(frame_config *fc)
+    {
+      frame_map_key key(fft_size, C_P2, C_DATA, N_FC, num_data_symbols, mapped_items, fc->cell_size, fc->fec_blocks, fc->ti_blocks, fc->N_post / fc->eta_mod);
+
+      init_dummy_randomizer(fc);
+      build_l1_caches(fc);
+      fc->frame_map = frame_map_cache.get(key, boost::bind(&frame_mapper_impl::build_frame_map, this, fc));
+    }
+
+    int
+    frame_mapper_impl::add_crc32_bits(unsigned char *in, int length)
+    {
+      unsigned int crc = l1_crc.compute(in, length);
+
+      in += length;
+      for (int n = 31; n >= 0; n--) {
+        *in++ = (crc & (1 << n)) ? 1 : 0;
+      }
+      return 32;
+    }
+
+/*
+ * The L1 codes are quasi-cyclic, so the parity addresses are generated
+ * on the fly from the standard tables instead of being expanded into a
+ * per-bit lookup. For bit n of a 360 bit group, the parity address is
+ * (x + n * q) mod pbits, and x + n * q never reaches 2 * pbits.
+ */
+#define LDPC_QC_ENCODE(TABLE_NAME, ROWS, Q) \
+for (int row = 0; row < ROWS; row++) { \
+  for (int n = 0; n < 360; n++) { \
+    if (d[im]) { \
+      for (int col = 1; col <= TABLE_NAME[row][0]; col++) { \
+        int addr = TABLE_NAME[row][col] + (n * Q); \
+        if (addr >= plen) { \
+          addr -= plen; \
+        } \
+        p[addr] ^= 1; \
+      } \
+    } \
+    im++; \
+  } \
+}
+
+    int
+    frame_mapper_impl::l1pre_bits(const frame_config *fc, unsigned char *l1pre) const
+    {
+      int temp, offset_bits = 0;
+      const L1Pre *l1preinit = &fc->L1_Signalling[0].l1pre_data;
+
+      temp = l1preinit->type;
+      for (int n = 7; n >= 0; n--) {
+        l1pre[offset_bits++] = temp & (1 << n) ? 1 : 0;
+      }
+      l1pre[offset_bits++] = l1preinit->bwt_ext;
+      temp = l1preinit->s1;
+      for (int n = 2; n >= 0; n--) {
+        l1pre[offset_bits++] = temp & (1 << n) ? 1 : 0;
+      }
+      temp = l1preinit->s2;
+      for (int n = 2; n >= 0; n--) {
+        l1pre[offset_bits++] = temp & (1 << n) ? 1 : 0;
+      }
+      l1pre[offset_bits++] = 0;
+      l1pre[offset_bits++] = l1preinit->l1_repetition_flag;
+      temp = l1preinit->guard_interval;
+      for (int n = 2; n >= 0; n--) {
+        l1pre[offset_bits++] = temp & (1 << n) ? 1 : 0;
+      }
+      temp = l1preinit->papr;
+      for (int n = 3; n >= 0; n--) {
+        l1pre[offset_bits++] = temp & (1 << n) ? 1 : 0;
+      }
+      temp = l1preinit->l1_mod;
+      for (int n = 3; n >= 0; n--) {
+        l1pre[offset_bits++] = temp & (1 << n) ? 1 : 0;
+      }
+      temp = l1preinit->l1_cod;
+      for (int n = 1; n >= 0; n--) {
+        l1pre[offset_bits++] = temp & (1 << n) ? 1 : 0;
+      }
+      temp = l1preinit->l1_fec_type;
+      for (int n = 1; n >= 0; n--) {
+        l1pre[offset_bits++] = temp & (1 << n) ? 1 : 0;
+      }
+      temp = l1preinit->l1_post_size;
+      for (int n = 17; n >= 0; n--) {
+        l1pre[offset_bits++] = temp & (1 << n) ? 1 : 0;
+      }
+      temp = l1preinit->l1_post_info_size;
+      for (int n = 17; n >= 0; n--) {
+        l1pre[offset_bits++] = temp & (1 << n) ? 1 : 0;
+      }
+      temp = l1preinit->pilot_pattern;
+      for (int n = 3; n >= 0; n--) {
+        l1pre[offset_bits++] = temp & (1 << n) ? 1 : 0;
+      }
+      temp = l1preinit->tx_id_availability;
+      for (int n = 7; n >= 0; n--) {
+        l1pre[offset_bits++] = temp & (1 << n) ? 1 : 0;
+      }
+      temp = l1preinit->cell_id;
+      for (int n = 15; n >= 0; n--) {
+        l1pre[offset_bits++] = temp & (1 << n) ? 1 : 0;
+      }
+      temp = l1preinit->network_id;
+      for (int n = 15; n >= 0; n--) {
+        l1pre[offset_bits++] = temp & (1 << n) ? 1 : 0;
+      }
+      temp = l1preinit->t2_system_id;
+      for (int n = 15; n >= 0; n--) {
+        l1pre[offset_bits++] = temp & (1 << n) ? 1 : 0;
+      }
+      temp = l1preinit->num_t2_frames;
+      for (int n = 7; n >= 0; n--) {
+        l1pre[offset_bits++] = temp & (1 << n) ? 1 : 0;
+      }
+      temp = l1preinit->num_data_symbols;
+      for (int n = 11; n >= 0; n--) {
+        l1pre[offset_bits++] = temp & (1 << n) ? 1 : 0;
+      }
+      temp = l1preinit->regen_flag;
+      for (int n = 2; n >= 0; n--) {
+        l1pre[offset_bits++] = temp & (1 << n) ? 1 : 0;
+      }
+      l1pre[offset_bits++] = l1preinit->l1_post_extension;
+      temp = l1preinit->num_rf;
+      for (int n = 2; n >= 0; n--) {
+        l1pre[offset_bits++] = temp & (1 << n) ? 1 : 0;
+      }
+      temp = l1preinit->current_rf_index;
+      for (int n = 2; n >= 0; n--) {
+        l1pre[offset_bits++] = temp & (1 << n) ? 1 : 0;
+      }
+      temp = l1preinit->t2_version;
+      for (int n = 3; n >= 0; n--) {
+        l1pre[offset_bits++] = temp & (1 << n) ? 1 : 0;
+      }
+      l1pre[offset_bits++] = l1preinit->l1_post_scrambled;
+      l1pre[offset_bits++] = l1preinit->t2_base_lite;
+      temp = l1preinit->reserved;
+      for (int n = 3; n >= 0; n--) {
+        l1pre[offset_bits++] = temp & (1 << n) ? 1 : 0;
+      }
+      return offset_bits;
+    }
+
+    void
+    frame_mapper_impl::add_l1pre(const frame_config *fc, gr_complex *out)
+    {
+      int offset_bits;
+      int plen = FRAME_SIZE_SHORT - NBCH_1_4;
+      const unsigned char *d;
+      unsigned char *p;
+      unsigned char *l1pre = l1_temp;
+      int g, o, index;
+      int im = 0;
+
+      offset_bits = l1pre_bits(fc, l1pre);
+      offset_bits += add_crc32_bits(l1pre, offset_bits);
+      /* Padding */
+      for (int n = KBCH_1_4 - offset_bits - 1; n >= 0; n--) {
+        l1pre[offset_bits++] = 0;
+      }
+      /* BCH */
+      l1_bch.encode(l1pre, KBCH_1_4, &l1pre[KBCH_1_4]);
+      /* LDPC */
+      d = l1_temp;
+      p = &l1_temp[NBCH_1_4];
+      memset(p, 0, sizeof(unsigned char)*plen);
+      LDPC_QC_ENCODE(ldpc_tab_1_4S, 9, 36);
+      for(int j = 1; j < plen; j++) {
+       p[j] ^= p[j-1];
+      }
+      /* Puncturing */
+      for (int c = 0; c < 31; c++) {
+        g = pre_puncture[c];
+        for (int c2 = 0; c2 < 360; c2++) {
+          o = (c2 * 36) + g + NBCH_1_4;
+          l1_temp[o] = 0x55;
+        }
+      }
+      g = pre_puncture[31];
+      for (int c2 = 0; c2 < 328; c2++) {
+        o = (c2 * 36) + g + NBCH_1_4;
+        l1_temp[o] = 0x55;
+      }
+      /* remove padding and punctured bits, BPSK modulate */
+      index = 0;
+      for (int w = 0; w < KSIG_PRE; w++) {
+        out[index++] = m_bpsk[l1_temp[w]];
+      }
+      for (int w = 0; w < NBCH_PARITY; w++) {
+        out[index++] = m_bpsk[l1_temp[w + KBCH_1_4]];
+      }
+      for (int w = 0; w < FRAME_SIZE_SHORT - NBCH_1_4; w++) {
+        if (l1_temp[w + NBCH_1_4] != 0x55) {
+          out[index++] = m_bpsk[l1_temp[w + NBCH_1_4]];
+        }
+      }
+    }
+
+    int
+    frame_mapper_impl::l1post_bits(const frame_config *fc, unsigned char *l1post, int t2_frame_num, int &conf_bits) const
+    {
+      int temp, offset_bits = 0;
+      const L1Post *l1postinit = &fc->L1_Signalling[0].l1post_data;
+
+      temp = l1postinit->sub_slices_per_frame;
+      for (int n = 14; n >= 0; n--) {
+        l1post[offset_bits++] = temp & (1 << n) ? 1 : 0;
+      }
+      temp = l1postinit->num_plp;
+      for (int n = 7; n >= 0; n--) {
+        l1post[offset_bits++] = temp & (1 << n) ? 1 : 0;
+      }
+      temp = l1postinit->num_aux;
+      for (int n = 3; n >= 0; n--) {
+        l1post[offset_bits++] = temp & (1 << n) ? 1 : 0;
+      }
+      temp = l1postinit->aux_config_rfu;
+      for (int n = 7; n >= 0; n--) {
+        l1post[offset_bits++] = temp & (1 << n) ? 1 : 0;
+      }
+      temp = l1postinit->rf_idx;
+      for (int n = 2; n >= 0; n--) {
+        l1post[offset_bits++] = temp & (1 << n) ? 1 : 0;
+      }
+      temp = l1postinit->frequency;
+      for (int n = 31; n >= 0; n--) {
+        l1post[offset_bits++] = temp & (1 << n) ? 1 : 0;
+      }
+      temp = l1postinit->plp_id;
+      for (int n = 7; n >= 0; n--) {
+        l1post[offset_bits++] = temp & (1 << n) ? 1 : 0;
+      }
+      temp = l1postinit->plp_type;
+      for (int n = 2; n >= 0; n--) {
+        l1post[offset_bits++] = temp & (1 << n) ? 1 : 0;
+      }
+      temp = l1postinit->plp_payload_type;
+      for (int n = 4; n >= 0; n--) {
+        l1post[offset_bits++] = temp & (1 << n) ? 1 : 0;
+      }
+      l1post[offset_bits++] = l1postinit->ff_flag;
+      temp = l1postinit->first_rf_idx;
+      for (int n = 2; n >= 0; n--) {
+        l1post[offset_bits++] = temp & (1 << n) ? 1 : 0;
+      }
+      temp = l1postinit->first_frame_idx;
+      for (int n = 7; n >= 0; n--) {
+        l1post[offset_bits++] = temp & (1 << n) ? 1 : 0;
+      }
+      temp = l1postinit->plp_group_id;
+      for (int n = 7; n >= 0; n--) {
+        l1post[offset_bits++] = temp & (1 << n) ? 1 : 0;
+      }
+      temp = l1postinit->plp_cod;
+      for (int n = 2; n >= 0; n--) {
+        l1post[offset_bits++] = temp & (1 << n) ? 1 : 0;
+      }
+      temp = l1postinit->plp_mod;
+      for (int n = 2; n >= 0; n--) {
+        l1post[offset_bits++] = temp & (1 << n) ? 1 : 0;
+      }
+      l1post[offset_bits++] = l1postinit->plp_rotation;
+      temp = l1postinit->plp_fec_type;
+      for (int n = 1; n >= 0; n--) {
+        l1post[offset_bits++] = temp & (1 << n) ? 1 : 0;
+      }
+      temp = l1postinit->plp_num_blocks_max;
+      for (int n = 9; n >= 0; n--) {
+        l1post[offset_bits++] = temp & (1 << n) ? 1 : 0;
+      }
+      temp = l1postinit->frame_interval;
+      for (int n = 7; n >= 0; n--) {
+        l1post[offset_bits++] = temp & (1 << n) ? 1 : 0;
+      }
+      temp = l1postinit->time_il_length;
+      for (int n = 7; n >= 0; n--) {
+        l1post[offset_bits++] = temp & (1 << n) ? 1 : 0;
+      }
+      l1post[offset_bits++] = l1postinit->time_il_type;
+      l1post[offset_bits++] = l1postinit->in_band_a_flag;
+      l1post[offset_bits++] = l1postinit->in_band_b_flag;
+      temp = l1postinit->reserved_1;
+      for (int n = 10; n >= 0; n--) {
+        l1post[offset_bits++] = temp & (1 << n) ? 1 : 0;
+      }
+      temp = l1postinit->plp_mode;
+      for (int n = 1; n >= 0; n--) {
+        l1post[offset_bits++] = temp & (1 << n) ? 1 : 0;
+      }
+      l1post[offset_bits++] = l1postinit->static_flag;
+      l1post[offset_bits++] = l1postinit->static_padding_flag;
+      temp = l1postinit->fef_length_msb;
+      for (int n = 1; n >= 0; n--) {
+        l1post[offset_bits++] = temp & (1 << n) ? 1 : 0;
+      }
+      temp = l1postinit->reserved_2;
+      for (int n = 29; n >= 0; n--) {
+        l1post[offset_bits++] = temp & (1 << n) ? 1 : 0;
+      }
+      conf_bits = offset_bits;
+      temp = t2_frame_num;
+      for (int n = 7; n >= 0; n--) {
+        l1post[offset_bits++] = temp & (1 << n) ? 1 : 0;
+      }
+      temp = l1postinit->sub_slice_interval;
+      for (int n = 21; n >= 0; n--) {
+        l1post[offset_bits++] = temp & (1 << n) ? 1 : 0;
+      }
+      temp = l1postinit->type_2_start;
+      for (int n = 21; n >= 0; n--) {
+        l1post[offset_bits++] = temp & (1 << n) ? 1 : 0;
+      }
+      temp = l1postinit->l1_change_counter;
+      for (int n = 7; n >= 0; n--) {
+        l1post[offset_bits++] = temp & (1 << n) ? 1 : 0;
+      }
+      temp = l1postinit->start_rf_idx;
+      for (int n = 2; n >= 0; n--) {
+        l1post[offset_bits++] = temp & (1 << n) ? 1 : 0;
+      }
+      temp = l1postinit->reserved_3;
+      for (int n = 7; n >= 0; n--) {
+        l1post[offset_bits++] = temp & (1 << n) ? 1 : 0;
+      }
+      temp = l1postinit->plp_id_dynamic;
+      for (int n = 7; n >= 0; n--) {
+        l1post[offset_bits++] = temp & (1 << n) ? 1 : 0;
+      }
+      temp = l1postinit->plp_start;
+      for (int n = 21; n >= 0; n--) {
+        l1post[offset_bits++] = temp & (1 << n) ? 1 : 0;
+      }
+      temp = l1postinit->plp_num_blocks;
+      for (int n = 9; n >= 0; n--) {
+        l1post[offset_bits++] = temp & (1 << n) ? 1 : 0;
+      }
+      temp = l1postinit->reserved_4;
+      for (int n = 7; n >= 0; n--) {
+        l1post[offset_bits++] = temp & (1 << n) ? 1 : 0;
+      }
+      temp = l1postinit->reserved_5;
+      for (int n = 7; n >= 0; n--) {
+        l1post[offset_bits++] = temp & (1 << n) ? 1 : 0;
+      }
+      return offset_bits;
+    }
+
+    void
+    frame_mapper_impl::add_l1post(const frame_config *fc, gr_complex *out, int t2_frame_num)
+    {
+      int offset_bits, conf_bits;
+      int plen = FRAME_SIZE_SHORT - NBCH_1_2;
+      const unsigned char *d;
+      unsigned char *p;
+      unsigned char *l1post = l1_interleave;
+      int N_post = fc->N_post;
+      int N_punc = fc->N_punc;
+      int m, g, o, last, index;
+      const int *post_padding;
+      const int *post_puncture;
+      int rows, numCols, mod, offset, pack, produced;
+      int im = 0;
+      unsigned char *cols[12];
+
+      offset_bits = l1post_bits(fc, l1post, t2_frame_num, conf_bits);
+      offset_bits += add_crc32_bits(l1post, offset_bits);
+      if (l1_scrambled == TRUE) {
+        for (int n = 0; n < offset_bits; n++) {
+          l1post[n] = l1post[n] ^ bb_prbs[n];
+        }
+      }
+      /* Padding */
+      switch (fc->l1_constellation) {
+        case L1_MOD_BPSK:
+          post_padding = post_padding_bqpsk;
+          break;
+        case L1_MOD_QPSK:
+          post_padding = post_padding_bqpsk;
+          break;
+        case L1_MOD_16QAM:
+          post_padding = post_padding_16qam;
+          break;
+        case L1_MOD_64QAM:
+          post_padding = post_padding_64qam;
+          break;
+        default:
+          post_padding = post_padding_bqpsk;
+          break;
+      }
+      memset(l1_map, 0, KBCH_1_2);
+      if (offset_bits <= 360) {
+        m = 20 - 1;
+        last = 360 - offset_bits;
+      }
+      else {
+        m = (KBCH_1_2 - offset_bits) / 360;
+        last = KBCH_1_2 - offset_bits - (360 * m);
+      }
+      for (int n = 0; n < m; n++) {
+        index = post_padding[n] * 360;
+        if (post_padding[n] == 19) {
+          for (int w = 0; w < 192; w++) {
+            l1_map[index++] = 0x7;
+          }
+        }
+        else {
+          for (int w = 0; w < 360; w++) {
+            l1_map[index++] = 0x7;
+          }
+        }
+      }
+      if (post_padding[m] == 19) {
+        index = (post_padding[m] * 360) + 192 - last;
+      }
+      else {
+        index = (post_padding[m] * 360) + 360 - last;
+      }
+      for (int w = 0; w < last; w++) {
+        l1_map[index++] = 0x7;
+      }
+      index = 0;
+      l1post = l1_temp;
+      for (int n = 0; n < KBCH_1_2; n++) {
+        if (l1_map[n] != 0x7) {
+          l1post[n] = l1_interleave[index++];
+        }
+        else {
+          l1post[n] = 0;
+        }
+      }
+      /* BCH */
+      l1_bch.encode(l1post, KBCH_1_2, &l1post[KBCH_1_2]);
+      /* LDPC */
+      d = l1_temp;
+      p = &l1_temp[NBCH_1_2];
+      memset(p, 0, sizeof(unsigned char)*plen);
+      LDPC_QC_ENCODE(ldpc_tab_1_2S, 20, 25);
+      for(int j = 1; j < plen; j++) {
+       p[j] ^= p[j-1];
+      }
+      /* Puncturing */
+      switch (fc->l1_constellation) {
+        case L1_MOD_BPSK:
+          post_puncture = post_puncture_bqpsk;
+          break;
+        case L1_MOD_QPSK:
+          post_puncture = post_puncture_bqpsk;
+          break;
+        case L1_MOD_16QAM:
+          post_puncture = post_puncture_16qam;
+          break;
+        case L1_MOD_64QAM:
+          post_puncture = post_puncture_64qam;
+          break;
+        default:
+          post_puncture = post_puncture_bqpsk;
+          break;
+      }
+      for (int c = 0; c < (N_punc / 360); c++) {
+        g = post_puncture[c];
+        for (int c2 = 0; c2 < 360; c2++) {
+          o = (c2 * 25) + g + NBCH_1_2;
+          l1_temp[o] = 0x55;
+        }
+      }
+      g = post_puncture[(N_punc / 360)];
+      for (int c2 = 0; c2 < (N_punc - ((N_punc / 360) * 360)); c2++) {
+        o = (c2 * 25) + g + NBCH_1_2;
+        l1_temp[o] = 0x55;
+      }
+      /* remove padding and punctured bits */
+      index = 0;
+      for (int w = 0; w < KBCH_1_2; w++) {
+        if (l1_map[w] != 0x7) {
+          l1_interleave[index++] = l1_temp[w];
+        }
+      }
+      for (int w = 0; w < NBCH_PARITY; w++) {
+        l1_interleave[index++] = l1_temp[w + KBCH_1_2];
+      }
+      for (int w = 0; w < FRAME_SIZE_SHORT - NBCH_1_2; w++) {
+        if (l1_temp[w + NBCH_1_2] != 0x55) {
+          l1_interleave[index++] = l1_temp[w + NBCH_1_2];
+        }
+      }
+      /* Bit interleave for 16QAM and 64QAM */
+      if (fc->l1_constellation == L1_MOD_16QAM || fc->l1_constellation == L1_MOD_64QAM) {
+        if (fc->l1_constellation == L1_MOD_16QAM) {
+          numCols = 8;
+          rows = N_post / 8;
+        }
+        else {
+          numCols = 12;
+          rows = N_post / 12;
+        }
+        for (int j = 0; j < numCols; j++) {
+          cols[j] = &l1_interleave[rows * j];
+        }
+        index = 0;
+        for (int k = 0; k < rows; k++) {
+          for (int w = 0; w < numCols; w++) {
+            *l1post++ = *(cols[w] + index);
+          }
+          index++;
+        }
+      }
+      switch (fc->l1_constellation) {
+        case L1_MOD_BPSK:
+          index = 0;
+          produced = 0;
+          for (int d = 0; d < N_post; d++) {
+            out[produced++] = m_bpsk[l1_interleave[index++]];
+          }
+          break;
+        case L1_MOD_QPSK:
+          mod = 2;
+          index = 0;
+          produced = 0;
+          for (int d = 0; d < N_post / mod; d++) {
+            pack = 0;
+            for (int e = 0; e < mod; e++) {
+              pack |= l1_interleave[index++];
+              pack <<= 1;
+            }
+            pack >>= 1;
+            out[produced++] = m_qpsk[pack];
+          }
+          break;
+        case L1_MOD_16QAM:
+          mod = 4;
+          index = 0;
+          produced = 0;
+          for (int d = 0; d < N_post / (mod * 2); d++) {
+            pack = 0;
+            for (int e = 0; e < (mod * 2); e++) {
+              offset = mux16[e];
+              pack |= l1_temp[index + offset];
+              pack <<= 1;
+            }
+            pack >>= 1;
+            out[produced++] = m_16qam[pack >> 4];
+            out[produced++] = m_16qam[pack & 0xf];
+            index += (mod * 2);
+          }
+          break;
+        case L1_MOD_64QAM:
+          mod = 6;
+          index = 0;
+          produced = 0;
+          for (int d = 0; d < N_post / (mod * 2); d++) {
+            pack = 0;
+            for (int e = 0; e < (mod * 2); e++) {
+              offset = mux64[e];
+              pack |= l1_temp[index + offset];
+              pack <<= 1;
+            }
+            pack >>= 1;
+            out[produced++] = m_64qam[pack >> 6];
+            out[produced++] = m_64qam[pack & 0x3f];
+            index += (mod * 2);
+          }
+          break;
+      }
+    }
+
+    /*
+     * The L1-post only changes with frame_idx, so encode and modulate
+     * one copy per T2 frame of the super-frame up front. Must be called
+     * again whenever L1_Signalling is modified.
+     */
+    void
+    frame_mapper_impl::build_l1_caches(frame_config *fc)
+    {
+      fc->l1pre_cache.resize(1840);
+      add_l1pre(fc, &fc->l1pre_cache[0]);
+      fc->l1post_cache.resize(fc->t2_frames * (fc->N_post / fc->eta_mod));
+      for (int n = 0; n < fc->t2_frames; n++) {
+        add_l1post(fc, &fc->l1post_cache[n * (fc->N_post / fc->eta_mod)], n);
+      }
+      fc->l1pre_cache_sc16.resize(fc->l1pre_cache.size());
+      cells_to_sc16(&fc->l1pre_cache[0], &fc->l1pre_cache_sc16[0], fc->l1pre_cache.size());
+      fc->l1post_cache_sc16.resize(fc->l1post_cache.size());
+      cells_to_sc16(&fc->l1post_cache[0], &fc->l1post_cache_sc16[0], fc->l1post_cache.size());
+    }
+
+    boost::shared_ptr<frame_mapper_impl::frame_config>
+    frame_mapper_impl::change_counter_config(const frame_config *fc, int count)
+    {
+      boost::shared_ptr<frame_config> announce(new frame_config(*fc));
+
+      announce->L1_Signalling[0].l1post_data.l1_change_counter = count;
+      build_l1_caches(announce.get());
+      return announce;
+    }
+
+    void
+    frame_mapper_impl::init_dummy_randomizer(frame_config *fc)
+    {
+      int num = mapped_items - fc->stream_items - 1840 - (fc->N_post / fc->eta_mod) - (N_FC - C_FC);
+      cell_vector_t *dummy = new cell_vector_t(num);
+      sc16_vector_t *dummy_sc16;
+
+      fc->dummy_randomize.reset(dummy);
+      for (int i = 0; i < num; i++) {
+        (*dummy)[i] = (bb_prbs[i % BB_PRBS_PERIOD] ? -1.0 : 1.0);
+      }
+      dummy_sc16 = new sc16_vector_t(num);
+      fc->dummy_randomize_sc16.reset(dummy_sc16);
+      cells_to_sc16(&(*dummy)[0], &(*dummy_sc16)[0], num);
+    }
+
+    /*
+     * For a given configuration, the path of every cell through the
+     * cell interleaver, the time interleaver column read, the frame
+     * builder (with the P2 zig-zag when N_P2 > 1) and the frequency
+     * interleaver is a fixed permutation. Trace it once with cell
+     * indices, so general_work() writes each cell exactly once.
+     * Returns a new map or throws std::bad_alloc.
+     *
+     * frame_map[] is in frame builder order: 1840 L1-pre cells, the
+     * L1-post cells, stream_items data cells (in input order), dummy
+     * cells and finally the unmodulated FCS cells, and holds the final
+     * output position of each.
+     */
+    frame_mapper_impl::frame_map_t *
+    frame_mapper_impl::build_frame_map(const frame_config *fc)
+    {
+      int *time_interleave, *cell_out, *assembled, *frame_in, *frame_map;
+      frame_map_t *map;
+      const std::vector<uint16_t> *H;
+      int stream_items = fc->stream_items;
+      int cell_size = fc->cell_size;
+      int N_post = fc->N_post;
+      int eta_mod = fc->eta_mod;
+      int l1_cells = 1840 + (N_post / eta_mod);
+      int FECBlocksPerTIBlock, shift, address, cell_index, rows, numCols, ti_index;
+      int index, read, save, count, symbol, produced;
+      int pn_degree, max_states, xor_size, pn_mask, result;
+      int n, temp;
+      std::vector<int> permutations(cell_size);
+      std::vector<int> ti_shift(fc->FECBlocksPerBigTIBlock);
+      int lfsr = 0;
+      int q = 0;
+      int logic11[2] = {0, 3};
+      int logic12[2] = {0, 2};
+      int logic13[4] = {0, 1, 4, 6};
+      int logic14[6] = {0, 1, 4, 5, 9, 11};
+      int logic15[4] = {0, 1, 2, 12};
+      int *logic;
+
+      if (fec_frame == FECFRAME_NORMAL) {
+        switch (fc->constellation) {
+          case MOD_QPSK:
+            pn_degree = 15;
+            pn_mask = 0x3fff;
+            max_states = 32768;
+            logic = &logic15[0];
+            xor_size = 4;
+            break;
+          case MOD_16QAM:
+            pn_degree = 14;
+            pn_mask = 0x1fff;
+            max_states = 16384;
+            logic = &logic14[0];
+            xor_size = 6;
+            break;
+          case MOD_64QAM:
+            pn_degree = 14;
+            pn_mask = 0x1fff;
+            max_states = 16384;
+            logic = &logic14[0];
+            xor_size = 6;
+            break;
+          case MOD_256QAM:
+            pn_degree = 13;
+            pn_mask = 0xfff;
+            max_states = 8192;
+            logic = &logic13[0];
+            xor_size = 4;
+            break;
+          default:
+            pn_degree = 15;
+            pn_mask = 0x3fff;
+            max_states = 32768;
+            logic = &logic15[0];
+            xor_size = 4;
+            break;
+        }
+      }
+      else {
+        switch (fc->constellation) {
+          case MOD_QPSK:
+            pn_degree = 13;
+            pn_mask = 0xfff;
+            max_states = 8192;
+            logic = &logic13[0];
+            xor_size = 4;
+            break;
+          case MOD_16QAM:
+            pn_degree = 12;
+            pn_mask = 0x7ff;
+            max_states = 4096;
+            logic = &logic12[0];
+            xor_size = 2;
+            break;
+          case MOD_64QAM:
+            pn_degree = 12;
+            pn_mask = 0x7ff;
+            max_states = 4096;
+            logic = &logic12[0];
+            xor_size = 2;
+            break;
+          case MOD_256QAM:
+            pn_degree = 11;
+            pn_mask = 0x3ff;
+            max_states = 2048;
+            logic = &logic11[0];
+            xor_size = 2;
+            break;
+          default:
+            pn_degree = 13;
+            pn_mask = 0xfff;
+            max_states = 8192;
+            logic = &logic13[0];
+            xor_size = 4;
+            break;
+        }
+      }
+      for (int i = 0; i < max_states; i++) {
+        if (i == 0 || i == 1) {
+          lfsr = 0;
+        }
+        else if (i == 2) {
+          lfsr = 1;
+        }
+        else {
+          result = 0;
+          for (int k = 0; k < xor_size; k++) {
+            result ^= (lfsr >> logic[k]) & 1;
+          }
+          lfsr &= pn_mask;
+          lfsr >>= 1;
+          lfsr |= result << (pn_degree - 2);
+        }
+        lfsr |= (i % 2) << (pn_degree - 1);
+        if (lfsr < cell_size) {
+          permutations[q++] = lfsr;
+        }
+      }
+      n = 0;
+      for (int r = 0; r < fc->FECBlocksPerBigTIBlock; r++) {
+        shift = cell_size;
+        while (shift >= cell_size) {
+          temp = n;
+          shift = 0;
+          for (int p = 0; p < pn_degree; p++) {
+            shift |= temp & 1;
+            shift <<= 1;
+            temp >>= 1;
+          }
+          n++;
+        }
+        ti_shift[r] = shift;
+      }
+      map = new frame_map_t(mapped_items);
+      time_interleave = (int *) malloc(sizeof(int) * stream_items);
+      cell_out = (int *) malloc(sizeof(int) * stream_items);
+      assembled = (int *) malloc(sizeof(int) * mapped_items);
+      frame_in = (int *) malloc(sizeof(int) * mapped_items);
+      if (time_interleave == NULL || cell_out == NULL || assembled == NULL || frame_in == NULL) {
+        free(frame_in);
+        free(assembled);
+        free(cell_out);
+        free(time_interleave);
+        delete map;
+        throw std::bad_alloc();
+      }
+      frame_map = &(*map)[0];
+      /* Cell and time interleaver */
+      cell_index = 0;
+      for (int s = 0; s < fc->numSmallTIBlocks + fc->numBigTIBlocks; s++) {
+        if (s < fc->numSmallTIBlocks) {
+          FECBlocksPerTIBlock = fc->FECBlocksPerSmallTIBlock;
+        }
+        else {
+          FECBlocksPerTIBlock = fc->FECBlocksPerBigTIBlock;
+        }
+        for (int r = 0; r < FECBlocksPerTIBlock; r++) {
+          shift = ti_shift[r];
+          for (int w = 0; w < cell_size; w++) {
+            address = permutations[w] + shift;
+            if (address >= cell_size) {
+              address -= cell_size;
+            }
+            time_interleave[address + cell_index] = cell_index + w;
+          }
+          cell_index += cell_size;
+        }
+      }
+      if (fc->ti_blocks != 0) {
+        produced = 0;
+        ti_index = 0;
+        for (int s = 0; s < fc->numSmallTIBlocks + fc->numBigTIBlocks; s++) {
+          if (s < fc->numSmallTIBlocks) {
+            FECBlocksPerTIBlock = fc->FECBlocksPerSmallTIBlock;
+          }
+          else {
+            FECBlocksPerTIBlock = fc->FECBlocksPerBigTIBlock;
+          }
+          numCols = 5 * FECBlocksPerTIBlock;
+          rows = cell_size / 5;
+          for (int k = 0; k < rows; k++) {
+            for (int w = 0; w < numCols; w++) {
+              cell_out[produced++] = time_interleave[(rows * w) + ti_index + k];
+            }
+          }
+          ti_index += rows * numCols;
+        }
+      }
+      else {
+        memcpy(cell_out, time_interleave, sizeof(int) * stream_items);
+      }
+      /* Frame builder */
+      for (int j = 0; j < mapped_items; j++) {
+        assembled[j] = j;
+      }
+      for (int j = 0; j < stream_items; j++) {
+        assembled[l1_cells + j] = l1_cells + cell_out[j];
+      }
+      if (N_P2 == 1) {
+        memcpy(frame_in, assembled, sizeof(int) * mapped_items);
+      }
+      else {
+        read = 0;
+        index = 0;
+        count = 0;
+        for (int n = 0; n < N_P2; n++) {
+          save = read;
+          for (int j = 0; j < 1840 / N_P2; j++) {
+            frame_in[index++] = assembled[read];
+            count++;
+            read += N_P2;
+          }
+          read = save + 1;
+          index += C_P2 - (1840 / N_P2);
+        }
+        read = 1840;
+        index = 1840 / N_P2;
+        for (int n = 0; n < N_P2; n++) {
+          save = read;
+          for (int j = 0; j < (N_post / eta_mod) / N_P2; j++) {
+            frame_in[index++] = assembled[read];
+            count++;
+            read += N_P2;
+          }
+          read = save + 1;
+          index += C_P2 - ((N_post / eta_mod) / N_P2);
+        }
+        read = 1840 + (N_post / eta_mod);
+        index = (1840 / N_P2) + ((N_post / eta_mod) / N_P2);
+        for (int n = 0; n < N_P2; n++) {
+          for (int j = 0; j < C_P2 - (1840 / N_P2) - ((N_post / eta_mod) / N_P2); j++) {
+            frame_in[index++] = assembled[read++];
+            count++;
+          }
+          index += C_P2 - (C_P2 - (1840 / N_P2) - ((N_post / eta_mod) / N_P2));
+        }
+        index -= C_P2 - (C_P2 - (1840 / N_P2) - ((N_post / eta_mod) / N_P2));
+        for (int j = 0; j < mapped_items - count; j++) {
+          frame_in[index++] = assembled[read++];
+        }
+      }
+      /* Frequency interleaver */
+      for (int j = 0; j < mapped_items; j++) {
+        frame_map[j] = -1;
+      }
+      produced = 0;
+      index = 0;
+      symbol = 0;
+      for (int j = 0; j < N_P2; j++) {
+        if ((symbol % 2) == 0) {
+          H = &fi->HevenP2;
+        }
+        else {
+          H = &fi->HoddP2;
+        }
+        for (int k = 0; k < C_P2; k++) {
+          frame_map[frame_in[index + (*H)[k]]] = produced++;
+        }
+        symbol++;
+        index += C_P2;
+      }
+      for (int j = 0; j < num_data_symbols; j++) {
+        if ((symbol % 2) == 0) {
+          H = &fi->Heven;
+        }
+        else {
+          H = &fi->Hodd;
+        }
+        for (int k = 0; k < C_DATA; k++) {
+          frame_map[frame_in[index + (*H)[k]]] = produced++;
+        }
+        symbol++;
+        index += C_DATA;
+      }
+      if (N_FC != 0) {
+        if ((symbol % 2) == 0) {
+          H = &fi->HevenFC;
+        }
+        else {
+          H = &fi->HoddFC;
+        }
+        for (int k = 0; k < N_FC; k++) {
+          frame_map[frame_in[index + (*H)[k]]] = produced++;
+        }
+        symbol++;
+      }
+      /* cells that don't fit in the T2 frame go to the unused tail */
+      for (int j = 0; j < mapped_items; j++) {
+        if (frame_map[j] == -1) {
+          frame_map[j] = produced++;
+        }
+      }
+      free(frame_in);
+      free(assembled);
+      free(cell_out);
+      free(time_interleave);
+      return map;
+    }
+
+    int
+    frame_mapper_impl::process(const gr_complex *in, gr_complex *out, int frames)
+    {
+      map_cells(cfg.get(), in, out, t2_frame_num, frames, 0, mapped_items);
+      skip_frames(frames);
+      return frames * cfg->stream_items;
+    }
+
+    int
+    frame_mapper_impl::process(const lv_16sc_t *in, lv_16sc_t *out, int frames)
+    {
+      map_cells(cfg.get(), in, out, t2_frame_num, frames, 0, mapped_items);
+      skip_frames(frames);
+      return frames * cfg->stream_items;
+    }
+
+    void
+    frame_mapper_impl::map_cells(const frame_config *fc, const gr_complex *in, gr_complex *out, int frame_num, int frames, int begin, int end) const
+    {
+      map_frames(fc, in, out, frame_num, frames, begin, end, &fc->l1pre_cache[0], &fc->l1post_cache[0], &(*fc->dummy_randomize)[0]);
+    }
+
+    void
+    frame_mapper_impl::map_cells(const frame_config *fc, const lv_16sc_t *in, lv_16sc_t *out, int frame_num, int frames, int begin, int end) const
+    {
+      map_frames(fc, in, out, frame_num, frames, begin, end, &fc->l1pre_cache_sc16[0], &fc->l1post_cache_sc16[0], &(*fc->dummy_randomize_sc16)[0]);
+    }
+
+    /* map_cells() for both cell formats, with the L1 and dummy cells in that format */
+    template <class T> void
+    frame_mapper_impl::map_frames(const frame_config *fc, const T *in, T *out, int frame_num, int frames, int begin, int end, const T *l1pre, const T *l1post, const T *dummy) const
+    {
+      const int *frame_map = &(*fc->frame_map)[0];
+      int l1post_cells = fc->N_post / fc->eta_mod;
+      int bounds[5];
+      const T *src[4];
+      int first, last, start;
+
+      bounds[0] = 1840;
+      bounds[1] = bounds[0] + l1post_cells;
+      bounds[2] = bounds[1] + fc->stream_items;
+      bounds[3] = mapped_items - (N_FC - C_FC);
+      bounds[4] = mapped_items;
+      for (int f = 0; f < frames; f++) {
+        src[0] = l1pre;
+        src[1] = &l1post[((frame_num + f) % fc->t2_frames) * l1post_cells];
+        src[2] = in;
+        src[3] = dummy;
+        start = 0;
+        for (int s = 0; s < 5; s++) {
+          first = std::max(begin, start);
+          last = std::min(end, bounds[s]);
+          if (s < 4) {
+            for (int k = first; k < last; k++) {
+              out[frame_map[k]] = src[s][k - start];
+            }
+          }
+          else {
+            for (int k = first; k < last; k++) {
+              out[frame_map[k]] = T(unmodulated.real(), unmodulated.imag());
+            }
+          }
+          start = bounds[s];
+        }
+        in += fc->stream_items;
+        out += mapped_items;
+      }
+    }
+
+    int
+    frame_mapper_impl::symbol_cells(int symbol) const
+    {
+      if (symbol < N_P2) {
+        return C_P2;
+      }
+      else if (symbol < N_P2 + num_data_symbols) {
+        return C_DATA;
+      }
+      return N_FC;
+    }
+
+    const unsigned short frame_mapper_impl::ldpc_tab_1_4S[9][13]=
+    {
+      {12,6295,9626,304,7695,4839,4936,1660,144,11203,5567,6347,12557},
+      {12,10691,4988,3859,3734,3071,3494,7687,10313,5964,8069,8296,11090},
+      {12,10774,3613,5208,11177,7676,3549,8746,6583,7239,12265,2674,4292},
+      {12,11869,3708,5981,8718,4908,10650,6805,3334,2627,10461,9285,11120},
+      {3,7844,3079,10773,0,0,0,0,0,0,0,0,0},
+      {3,3385,10854,5747,0,0,0,0,0,0,0,0,0},
+      {3,1360,12010,12202,0,0,0,0,0,0,0,0,0},
+      {3,6189,4241,2343,0,0,0,0,0,0,0,0,0},
+      {3,9840,12726,4977,0,0,0,0,0,0,0,0,0}
+    };
+
+    const unsigned short frame_mapper_impl::ldpc_tab_1_2S[20][9]=
+    {
+      {8,20,712,2386,6354,4061,1062,5045,5158},
+      {8,21,2543,5748,4822,2348,3089,6328,5876},
+      {8,22,926,5701,269,3693,2438,3190,3507},
+      {8,23,2802,4520,3577,5324,1091,4667,4449},
+      {8,24,5140,2003,1263,4742,6497,1185,6202},
+      {3,0,4046,6934,0,0,0,0,0},
+      {3,1,2855,66,0,0,0,0,0},
+      {3,2,6694,212,0,0,0,0,0},
+      {3,3,3439,1158,0,0,0,0,0},
+      {3,4,3850,4422,0,0,0,0,0},
+      {3,5,5924,290,0,0,0,0,0},
+      {3,6,1467,4049,0,0,0,0,0},
+      {3,7,7820,2242,0,0,0,0,0},
+      {3,8,4606,3080,0,0,0,0,0},
+      {3,9,4633,7877,0,0,0,0,0},
+      {3,10,3884,6868,0,0,0,0,0},
+      {3,11,8935,4996,0,0,0,0,0},
+      {3,12,3028,764,0,0,0,0,0},
+      {3,13,5988,1057,0,0,0,0,0},
+      {3,14,7411,3450,0,0,0,0,0}
+    };
+
+    const int frame_mapper_impl::pre_puncture[36] = 
+    {
+      27, 13, 29, 32, 5, 0, 11, 21, 33, 20, 25, 28, 18, 35, 8, 3, 9, 31, 22, 24, 7, 14, 17, 4, 2, 26, 16, 34, 19, 10, 12, 23, 1, 6, 30, 15
+    };
+
+    const int frame_mapper_impl::post_padding_bqpsk[20] = 
+    {
+      18, 17, 16, 15, 14, 13, 12, 11, 4, 10, 9, 8, 3, 2, 7, 6, 5, 1, 19, 0
+    };
+
+    const int frame_mapper_impl::post_padding_16qam[20] = 
+    {
+      18, 17, 16, 15, 14, 13, 12, 11, 4, 10, 9, 8, 7, 3, 2, 1, 6, 5, 19, 0
+    };
+
+    const int frame_mapper_impl::post_padding_64qam[20] = 
+    {
+      18, 17, 16, 4, 15, 14, 13, 12, 3, 11, 10, 9, 2, 8, 7, 1, 6, 5, 19, 0
+    };
+
+    const int frame_mapper_impl::post_puncture_bqpsk[25] = 
+    {
+      6, 4, 18, 9, 13, 8, 15, 20, 5, 17, 2, 24, 10, 22, 12, 3, 16, 23, 1, 14, 0, 21, 19, 7, 11
+    };
+
+    const int frame_mapper_impl::post_puncture_16qam[25] = 
+    {
+      6, 4, 13, 9, 18, 8, 15, 20, 5, 17, 2, 22, 24, 7, 12, 1, 16, 23, 14, 0, 21, 10, 19, 11, 3
+    };
+
+    const int frame_mapper_impl::post_puncture_64qam[25] = 
+    {
+      6, 15, 13, 10, 3, 17, 21, 8, 5, 19, 2, 23, 16, 24, 7, 18, 1, 12, 20, 0, 4, 14, 9, 11, 22
+    };
+
+    const int frame_mapper_impl::mux16[8] =
+    {
+      7, 1, 3, 5, 2, 4, 6, 0
+    };
+
+    const int frame_mapper_impl::mux64[12] =
+    {
+      11, 8, 5, 2, 10, 7, 4, 1, 9, 6, 3, 0
+    };
+
+    const int frame_mapper_impl::bitperm1keven[9] = 
+    {
+      8, 7, 6, 5, 0, 1, 2, 3, 4
+    };
+
+    const int frame_mapper_impl::bitperm1kodd[9] = 
+    {
+      6, 8, 7, 4, 1, 0, 5, 2, 3
+    };
+
+    const int frame_mapper_impl::bitperm2keven[10] = 
+    {
+      4, 3, 9, 6, 2, 8, 1, 5, 7, 0
+    };
+
+    const int frame_mapper_impl::bitperm2kodd[10] = 
+    {
+     6, 9, 4, 8, 5, 1, 0, 7, 2, 3
+    };
+
+    const int frame_mapper_impl::bitperm4keven[11] = 
+    {
+      6, 3, 0, 9, 4, 2, 1, 8, 5, 10, 7
+    };
+
+    const int frame_mapper_impl::bitperm4kodd[11] = 
+    {
+      5, 9, 1, 4, 3, 0, 8, 10, 7, 2, 6
+    };
+
+    const int frame_mapper_impl::bitperm8keven[12] = 
+    {
+      7, 1, 4, 2, 9, 6, 8, 10, 0, 3, 11, 5
+    };
+
+    const int frame_mapper_impl::bitperm8kodd[12] = 
+    {
+      11, 4, 9, 3, 1, 2, 5, 0, 6, 7, 10, 8
+    };
+
+    const int frame_mapper_impl::bitperm16keven[13] = 
+    {
+      9, 7, 6, 10, 12, 5, 1, 11, 0, 2, 3, 4, 8
+    };
+
+    const int frame_mapper_impl::bitperm16kodd[13] = 
+    {
+      6, 8, 10, 12, 2, 0, 4, 1, 11, 3, 5, 9, 7
+    };
+
+    const int frame_mapper_impl::bitperm32k[14] = 
+    {
+      7, 13, 3, 4, 9, 2, 12, 11, 1, 8, 10, 0, 5, 6
+    };
+
+  } /* namespace dvbt2ll */
+} /* namespace gr */
+
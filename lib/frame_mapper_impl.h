@@ -0,0 +1,310 @@
+/* -*- c++ -*- */
+/* 
+ * Copyright 2017 Ron Economos.
+ * 
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ * 
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_DVBT2LL_FRAME_MAPPER_IMPL_H
+#define INCLUDED_DVBT2LL_FRAME_MAPPER_IMPL_H
+
+#include <dvbt2ll/frame_mapper.h>
+#include "bch_crc_engine.h"
+#include "dvbt2_tables.h"
+#include "table_cache.h"
+#include "frame_buffer.h"
+#include <boost/shared_ptr.hpp>
+#include <boost/bind.hpp>
+#include <boost/tuple/tuple.hpp>
+#include <boost/tuple/tuple_comparison.hpp>
+#include <stdint.h>
+#include <vector>
+
+#define KBCH_1_4 3072
+#define NBCH_1_4 3240
+#define KBCH_1_2 7032
+#define NBCH_1_2 7200
+
+#define KSIG_PRE 200
+#define KSIG_POST 350
+#define NBCH_PARITY 168
+
+typedef struct{
+    int type;
+    int bwt_ext;
+    int s1;
+    int s2;
+    int l1_repetition_flag;
+    int guard_interval;
+    int papr;
+    int l1_mod;
+    int l1_cod;
+    int l1_fec_type;
+    int l1_post_size;
+    int l1_post_info_size;
+    int pilot_pattern;
+    int tx_id_availability;
+    int cell_id;
+    int network_id;
+    int t2_system_id;
+    int num_t2_frames;
+    int num_data_symbols;
+    int regen_flag;
+    int l1_post_extension;
+    int num_rf;
+    int current_rf_index;
+    int t2_version;
+    int l1_post_scrambled;
+    int t2_base_lite;
+    int reserved;
+    int crc_32;
+}L1Pre;
+
+typedef struct{
+    int sub_slices_per_frame;
+    int num_plp;
+    int num_aux;
+    int aux_config_rfu;
+    int rf_idx;
+    int frequency;
+    int plp_id;
+    int plp_type;
+    int plp_payload_type;
+    int ff_flag;
+    int first_rf_idx;
+    int first_frame_idx;
+    int plp_group_id;
+    int plp_cod;
+    int plp_mod;
+    int plp_rotation;
+    int plp_fec_type;
+    int plp_num_blocks_max;
+    int frame_interval;
+    int time_il_length;
+    int time_il_type;
+    int in_band_a_flag;
+    int in_band_b_flag;
+    int reserved_1;
+    int plp_mode;
+    int static_flag;
+    int static_padding_flag;
+    int fef_length_msb;
+    int reserved_2;
+    int frame_idx;
+    int sub_slice_interval;
+    int type_2_start;
+    int l1_change_counter;
+    int start_rf_idx;
+    int reserved_3;
+    int plp_id_dynamic;
+    int plp_start;
+    int plp_num_blocks;
+    int reserved_4;
+    int reserved_5;
+}L1Post;
+
+typedef struct{
+   L1Pre l1pre_data;
+   L1Post l1post_data;
+}L1Signalling;
+
+namespace gr {
+  namespace dvbt2ll {
+
+    class DVBT2LL_CORE_API frame_mapper_impl : public frame_mapper
+    {
+     public:
+      /* The tables map_cells() sweeps every frame, see frame_buffer.h */
+      typedef std::vector<int, frame_allocator<int> > frame_map_t;
+      typedef std::vector<gr_complex, frame_allocator<gr_complex> > cell_vector_t;
+      typedef std::vector<lv_16sc_t, frame_allocator<lv_16sc_t> > sc16_vector_t;
+
+      /*
+       * Everything that depends on the parameters that can be changed
+       * at run time. framemapperfint_cc builds a new one on a helper
+       * thread and swaps it in at a super-frame boundary.
+       */
+      struct frame_config
+      {
+        int constellation;
+        int rotation;
+        int fec_blocks;
+        int ti_blocks;
+        int l1_constellation;
+        int t2_frames;
+        int cell_size;
+        int stream_items;
+        int eta_mod;
+        int N_post;
+        int N_punc;
+        int FECBlocksPerSmallTIBlock;
+        int FECBlocksPerBigTIBlock;
+        int numBigTIBlocks;
+        int numSmallTIBlocks;
+        L1Signalling L1_Signalling[1];
+        boost::shared_ptr<const frame_map_t> frame_map;
+        boost::shared_ptr<const cell_vector_t> dummy_randomize;
+        std::vector<gr_complex> l1pre_cache;
+        std::vector<gr_complex> l1post_cache;
+        /* The same as Q2.13 cells, for the sc16 cell format */
+        boost::shared_ptr<const sc16_vector_t> dummy_randomize_sc16;
+        std::vector<lv_16sc_t> l1pre_cache_sc16;
+        std::vector<lv_16sc_t> l1post_cache_sc16;
+      };
+     private:
+      boost::shared_ptr<frame_config> cfg;
+      int fec_frame;
+      int mapped_items;
+      int fft_size;
+      int t2_frame_num;
+      int l1_scrambled;
+      int N_P2;
+      int C_P2;
+      int N_FC;
+      int C_FC;
+      int C_DATA;
+      int total_symbols;
+      bool setup_fits;
+      void setup_config(frame_config *, int, int, int, int, int, int);
+      void add_l1pre(const frame_config *, gr_complex *);
+      void add_l1post(const frame_config *, gr_complex *, int);
+      void build_l1_caches(frame_config *);
+      frame_map_t *build_frame_map(const frame_config *);
+      int add_crc32_bits(unsigned char *, int);
+      crc32_engine l1_crc;
+      bch_engine l1_bch;
+      void poly_reverse(int*, int*, int);
+      void init_dummy_randomizer(frame_config *);
+      template <class T> void map_frames(const frame_config *, const T *, T *, int, int, int, int, const T *, const T *, const T *) const;
+      unsigned char l1_temp[FRAME_SIZE_SHORT];
+      unsigned char l1_interleave[FRAME_SIZE_SHORT];
+      unsigned char l1_map[KBCH_1_2];
+      gr_complex unmodulated;
+      gr_complex m_bpsk[2];
+      gr_complex m_qpsk[4];
+      gr_complex m_16qam[16];
+      gr_complex m_64qam[64];
+
+      const static unsigned short ldpc_tab_1_4S[9][13];
+      const static unsigned short ldpc_tab_1_2S[20][9];
+
+      const static int pre_puncture[36];
+      const static int post_padding_bqpsk[20];
+      const static int post_padding_16qam[20];
+      const static int post_padding_64qam[20];
+      const static int post_puncture_bqpsk[25];
+      const static int post_puncture_16qam[25];
+      const static int post_puncture_64qam[25];
+
+      const static int mux16[8];
+      const static int mux64[12];
+
+      int num_data_symbols;
+
+      /*
+       * Frequency interleaver tables, sized for the actual number of
+       * cells and shared by all instances with the same FFT size,
+       * P2, data and frame closing symbol cell counts.
+       */
+      struct fi_tables
+      {
+        std::vector<uint16_t> Heven;
+        std::vector<uint16_t> Hodd;
+        std::vector<uint16_t> HevenP2;
+        std::vector<uint16_t> HoddP2;
+        std::vector<uint16_t> HevenFC;
+        std::vector<uint16_t> HoddFC;
+      };
+      typedef boost::tuple<int, int, int, int> fi_key;
+      static table_cache<fi_key, fi_tables> fi_cache;
+      boost::shared_ptr<const fi_tables> fi;
+      fi_tables *build_fi_tables(int);
+
+      /* FFT size, C_P2, C_DATA, N_FC, data symbols, mapped cells, cell size, FEC blocks, TI blocks, L1-post cells */
+      typedef boost::tuple<int, int, int, int, int, int, int, int, int, int> frame_map_key;
+      static table_cache<frame_map_key, frame_map_t> frame_map_cache;
+
+      const static int bitperm1keven[9];
+      const static int bitperm1kodd[9];
+      const static int bitperm2keven[10];
+      const static int bitperm2kodd[10];
+      const static int bitperm4keven[11];
+      const static int bitperm4kodd[11];
+      const static int bitperm8keven[12];
+      const static int bitperm8kodd[12];
+      const static int bitperm16keven[13];
+      const static int bitperm16kodd[13];
+      const static int bitperm32k[14];
+
+     public:
+      frame_mapper_impl(dvbt2_framesize_t framesize, dvbt2_code_rate_t rate, dvbt2_constellation_t constellation, dvbt2_rotation_t rotation, int fecblocks, int tiblocks, dvbt2_extended_carrier_t carriermode, dvbt2_fftsize_t fftsize, dvbt2_guardinterval_t guardinterval, dvbt2_l1constellation_t l1constellation, dvbt2_pilotpattern_t pilotpattern, int t2frames, int numdatasyms, dvbt2_papr_t paprmode, dvbt2_version_t version, dvbt2_preamble_t preamble, dvbt2_inputmode_t inputmode, dvbt2_reservedbiasbits_t reservedbiasbits, dvbt2_l1scrambled_t l1scrambled, dvbt2_inband_t inband);
+      ~frame_mapper_impl();
+
+      int input_items() const { return cfg->stream_items; }
+      int output_items() const { return mapped_items; }
+      bool fits() const { return setup_fits; }
+      int process(const gr_complex *, gr_complex *, int);
+      int process(const lv_16sc_t *, lv_16sc_t *, int);
+
+      /* OFDM symbols per T2 frame and the cells of each */
+      int symbols() const { return total_symbols; }
+      int symbol_cells(int symbol) const;
+
+      /* T2 frame number in the super-frame of the next frame */
+      int t2_frame() const { return t2_frame_num; }
+      void skip_frames(int frames) { t2_frame_num = (t2_frame_num + frames) % cfg->t2_frames; }
+
+      /*
+       * Writes cells [begin, end) of the frame builder order (see
+       * build_frame_map()) for frames consecutive T2 frames. Doesn't
+       * touch the frame number, so two threads can share a frame.
+       */
+      void map_cells(const frame_config *, const gr_complex *, gr_complex *, int, int, int, int) const;
+      void map_cells(const frame_config *, const lv_16sc_t *, lv_16sc_t *, int, int, int, int) const;
+
+      /*
+       * Configuration changes. new_config() fills in a configuration
+       * with the L1 fields of the current one, build_config() makes
+       * its tables (and can run on another thread, it throws
+       * std::bad_alloc) and use_config() swaps it in.
+       */
+      const frame_config *config() const { return cfg.get(); }
+      boost::shared_ptr<frame_config> new_config(int constellation, int rotation, int fecblocks, int tiblocks, int l1constellation, int t2frames);
+      bool config_fits(const frame_config *) const;
+      void build_config(frame_config *);
+      void use_config(boost::shared_ptr<frame_config> fc) { cfg = fc; }
+      /*
+       * A copy of fc that announces a change in count super-frames in
+       * L1_CHANGE_COUNTER. Only its L1 caches are its own, the other
+       * tables are shared. Can run on another thread like
+       * build_config().
+       */
+      boost::shared_ptr<frame_config> change_counter_config(const frame_config *fc, int count);
+
+      /*
+       * The L1-pre and L1-post fields of T2 frame t2_frame_num, one
+       * bit per byte, without the CRC, padding or scrambling. They
+       * return the number of bits, conf_bits is set to the length of
+       * the configurable part of the L1-post. For t2miencap_bb.
+       */
+      int l1pre_bits(const frame_config *, unsigned char *) const;
+      int l1post_bits(const frame_config *, unsigned char *, int, int &conf_bits) const;
+    };
+
+  } // namespace dvbt2ll
+} // namespace gr
+
+#endif /* INCLUDED_DVBT2LL_FRAME_MAPPER_IMPL_H */
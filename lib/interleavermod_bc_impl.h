@@ -22,6 +22,10 @@
 #define INCLUDED_DVBT2LL_INTERLEAVERMOD_BC_IMPL_H
 
 #include <dvbt2ll/interleavermod_bc.h>
+#include "cell_modulator_impl.h"
+#include "latency_tags.h"
+#include "modcod_tag.h"
+#include "perf_counters.h"
 
 namespace gr {
   namespace dvbt2ll {
@@ -29,61 +33,24 @@ namespace gr {
     class interleavermod_bc_impl : public interleavermod_bc
     {
      private:
-      int frame_size;
-      int signal_constellation;
-      int code_rate;
-      int nbch;
-      int q_val;
-      int mod;
-      int cyclic_delay;
+      cell_modulator_impl modulator;
       int cell_size;
-      unsigned char tempu[FRAME_SIZE_NORMAL];
-      unsigned char tempv[FRAME_SIZE_NORMAL];
+      int cell_format;
 
-      const static int twist16n[8];
-      const static int twist64n[12];
-      const static int twist256n[16];
+      bool modcod_pending;
+      uint64_t modcod_offset;
+      int modcod_constellation;
+      int modcod_rotation;
+      pmt::pmt_t modcod_key;
 
-      const static int twist16s[8];
-      const static int twist64s[12];
-      const static int twist256s[8];
-
-      const static int mux16[8];
-      const static int mux64[12];
-      const static int mux256[16];
-
-      const static int mux16_35[8];
-      const static int mux16_13[8];
-      const static int mux16_25[8];
-      const static int mux64_35[12];
-      const static int mux64_13[12];
-      const static int mux64_25[12];
-      const static int mux256_35[16];
-      const static int mux256_23[16];
-
-      const static int mux256s[8];
-      const static int mux256s_13[8];
-      const static int mux256s_25[8];
-
-      gr_complex m_qpsk[4];
-      gr_complex m_16qam[16];
-      gr_complex m_64qam[64];
-      gr_complex m_256qam[256];
-
-      int pn_degree;
-      int ti_blocks;
-      int fec_blocks;
-      int permutations[32768];
-      int FECBlocksPerSmallTIBlock;
-      int FECBlocksPerBigTIBlock;
-      int numBigTIBlocks;
-      int numSmallTIBlocks;
-      int interleaved_items;
-      gr_complex *time_interleave;
-      gr_complex **cols;
+      latency_fifo latency;
+      pmt::pmt_t latency_key;
+      perf_counters perf;
+      int perf_interleave;
+      void handle_modcod(pmt::pmt_t);
 
      public:
-      interleavermod_bc_impl(dvbt2_framesize_t framesize, dvbt2_code_rate_t rate, dvbt2_constellation_t constellation, dvbt2_rotation_t rotation);
+      interleavermod_bc_impl(dvbt2_framesize_t framesize, dvbt2_code_rate_t rate, dvbt2_constellation_t constellation, dvbt2_rotation_t rotation, dvbt2_cellformat_t cellformat);
       ~interleavermod_bc_impl();
 
       // Where all the action really happens
@@ -0,0 +1,136 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2017 Ron Economos.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_DVBT2LL_LATENCY_TAGS_H
+#define INCLUDED_DVBT2LL_LATENCY_TAGS_H
+
+#include <gnuradio/tags.h>
+#include <pmt/pmt.h>
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <vector>
+
+/*
+ * Key of the stream tag bbheaderbch_bb puts on the first bit of every
+ * BBFRAME when latency tagging is on. The value is the
+ * gr::high_res_timer_now() time at which the first TS byte of the
+ * frame reached the block.
+ */
+#define LATENCY_TAG "ts_time"
+
+/* 0.5 ms bins up to 2 s, longer latencies go to the last bin */
+#define LATENCY_BINS 4000
+#define LATENCY_BIN_WIDTH 0.0005
+
+namespace gr {
+  namespace dvbt2ll {
+
+    /*
+     * Time stamps of the latency tags seen on an input, in stream
+     * order. Each FEC block or T2 frame takes the next stamp, so a
+     * block in between that moves the tag offsets (the LDPC encoder
+     * keeps a relative rate of 1) doesn't matter as long as it passes
+     * one tag per FEC block. The whole input window can be passed on
+     * every call, tags that were already queued are skipped.
+     */
+    class latency_fifo
+    {
+     private:
+      std::deque<uint64_t> d_stamps;
+      uint64_t d_next_offset;
+
+     public:
+      latency_fifo() : d_next_offset(0) {}
+
+      void push(const std::vector<tag_t> &tags)
+      {
+        for (size_t i = 0; i < tags.size(); i++) {
+          if (tags[i].offset >= d_next_offset) {
+            d_stamps.push_back(pmt::to_uint64(tags[i].value));
+            d_next_offset = tags[i].offset + 1;
+          }
+        }
+      }
+
+      bool pop(uint64_t &stamp)
+      {
+        if (d_stamps.empty()) {
+          return false;
+        }
+        stamp = d_stamps.front();
+        d_stamps.pop_front();
+        return true;
+      }
+
+      /* Drops the stamps of FEC blocks that share a T2 frame's tag */
+      void skip(int count)
+      {
+        while (count-- > 0 && !d_stamps.empty()) {
+          d_stamps.pop_front();
+        }
+      }
+    };
+
+    /*
+     * Latency histogram for the p50/p99/max published by
+     * pilotgenp1insert_cc. Percentiles are the upper edge of their bin.
+     */
+    class latency_histogram
+    {
+     private:
+      std::vector<uint64_t> d_bins;
+      uint64_t d_count;
+      double d_max;
+
+     public:
+      latency_histogram() : d_bins(LATENCY_BINS, 0), d_count(0), d_max(0.0) {}
+
+      void add(double seconds)
+      {
+        int bin = (int)(seconds / LATENCY_BIN_WIDTH);
+
+        d_bins[std::max(0, std::min(bin, LATENCY_BINS - 1))]++;
+        d_count++;
+        d_max = std::max(d_max, seconds);
+      }
+
+      double percentile(double fraction) const
+      {
+        uint64_t rank = (uint64_t)std::ceil(fraction * d_count);
+        uint64_t total = 0;
+
+        for (int i = 0; i < LATENCY_BINS - 1; i++) {
+          total += d_bins[i];
+          if (total >= rank && total > 0) {
+            return std::min((i + 1) * LATENCY_BIN_WIDTH, d_max);
+          }
+        }
+        return d_max;
+      }
+
+      uint64_t count() const { return d_count; }
+      double max() const { return d_max; }
+    };
+
+  } // namespace dvbt2ll
+} // namespace gr
+
+#endif /* INCLUDED_DVBT2LL_LATENCY_TAGS_H */
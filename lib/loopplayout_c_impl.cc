@@ -0,0 +1,317 @@
+/* -*- c++ -*- */
+/* 
+ * Copyright 2017 Ron Economos.
+ * 
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ * 
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gnuradio/io_signature.h>
+#include "loopplayout_c_impl.h"
+#include <boost/crc.hpp>
+#include <algorithm>
+#include <stdexcept>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace gr {
+  namespace dvbt2ll {
+
+    loopplayout_c::sptr
+    loopplayout_c::make(const std::string &tsfile, const std::string &cachefile, dvbt2_framesize_t framesize, dvbt2_code_rate_t rate, dvbt2_constellation_t constellation, dvbt2_rotation_t rotation, int fecblocks, int tiblocks, dvbt2_extended_carrier_t carriermode, dvbt2_fftsize_t fftsize, dvbt2_guardinterval_t guardinterval, dvbt2_l1constellation_t l1constellation, dvbt2_pilotpattern_t pilotpattern, int t2frames, int numdatasyms, dvbt2_papr_t paprmode, dvbt2_version_t version, dvbt2_preamble_t preamble, dvbt2_inputmode_t inputmode, dvbt2_reservedbiasbits_t reservedbiasbits, dvbt2_l1scrambled_t l1scrambled, dvbt2_inband_t inband, int tsrate, dvbt2_misogroup_t misogroup, dvbt2_equalization_t equalization, dvbt2_bandwidth_t bandwidth, int vlength, int maxframes)
+    {
+      return gnuradio::get_initial_sptr
+        (new loopplayout_c_impl(tsfile, cachefile, framesize, rate, constellation, rotation, fecblocks, tiblocks, carriermode, fftsize, guardinterval, l1constellation, pilotpattern, t2frames, numdatasyms, paprmode, version, preamble, inputmode, reservedbiasbits, l1scrambled, inband, tsrate, misogroup, equalization, bandwidth, vlength, maxframes));
+    }
+
+    /*
+     * The private constructor
+     */
+    loopplayout_c_impl::loopplayout_c_impl(const std::string &tsfile, const std::string &cachefile, dvbt2_framesize_t framesize, dvbt2_code_rate_t rate, dvbt2_constellation_t constellation, dvbt2_rotation_t rotation, int fecblocks, int tiblocks, dvbt2_extended_carrier_t carriermode, dvbt2_fftsize_t fftsize, dvbt2_guardinterval_t guardinterval, dvbt2_l1constellation_t l1constellation, dvbt2_pilotpattern_t pilotpattern, int t2frames, int numdatasyms, dvbt2_papr_t paprmode, dvbt2_version_t version, dvbt2_preamble_t preamble, dvbt2_inputmode_t inputmode, dvbt2_reservedbiasbits_t reservedbiasbits, dvbt2_l1scrambled_t l1scrambled, dvbt2_inband_t inband, int tsrate, dvbt2_misogroup_t misogroup, dvbt2_equalization_t equalization, dvbt2_bandwidth_t bandwidth, int vlength, int maxframes)
+      : gr::sync_block("loopplayout_c",
+              gr::io_signature::make(0, 0, 0),
+              gr::io_signature::make(1, 1, sizeof(gr_complex))),
+        cache_file(cachefile), cache(NULL), cache_size(0), samples(NULL),
+        total_items(0), position(0)
+    {
+      const int params[] = {CACHE_VERSION, (int)sizeof(gr_complex), framesize, rate, constellation, rotation, fecblocks, tiblocks, carriermode, fftsize, guardinterval, l1constellation, pilotpattern, t2frames, numdatasyms, paprmode, version, preamble, inputmode, reservedbiasbits, l1scrambled, inband, tsrate, misogroup, equalization, bandwidth, vlength, maxframes};
+      std::vector<unsigned char> loop;
+      boost::crc_32_type crc;
+
+      if (misogroup == MISO_TX1_TX2) {
+        throw std::invalid_argument("Loop Playout, MISO TX1 and TX2 needs the two outputs of the Pilot Generator");
+      }
+      read_loop(tsfile, loop);
+      crc.process_bytes(params, sizeof(params));
+      crc.process_bytes(&loop[0], loop.size());
+      checksum = crc.checksum();
+
+      if (!open_cache()) {
+        bbframe_encoder_impl encoder(framesize, rate, inputmode, inband, fecblocks, tsrate);
+        cell_modulator_impl modulator(framesize, rate, constellation, rotation);
+        frame_mapper_impl mapper(framesize, rate, constellation, rotation, fecblocks, tiblocks, carriermode, fftsize, guardinterval, l1constellation, pilotpattern, t2frames, numdatasyms, paprmode, version, preamble, inputmode, reservedbiasbits, l1scrambled, inband);
+        ofdm_modulator_impl ofdm(carriermode, fftsize, pilotpattern, guardinterval, numdatasyms, paprmode, version, preamble, misogroup, equalization, bandwidth, vlength);
+
+        if (!mapper.fits()) {
+          GR_LOG_WARN(d_logger, "Loop Playout, too many FEC blocks in T2 frame.");
+        }
+        build_cache(loop, encoder, modulator, mapper, ofdm, fecblocks, t2frames, std::max(maxframes, t2frames));
+      }
+    }
+
+    /*
+     * Our virtual destructor.
+     */
+    loopplayout_c_impl::~loopplayout_c_impl()
+    {
+      if (cache != NULL) {
+        munmap(cache, cache_size);
+      }
+    }
+
+    /* The whole TS packets of tsfile */
+    void
+    loopplayout_c_impl::read_loop(const std::string &tsfile, std::vector<unsigned char> &loop)
+    {
+      FILE *fp = fopen(tsfile.c_str(), "rb");
+      size_t length = 0;
+
+      if (fp != NULL) {
+        fseek(fp, 0, SEEK_END);
+        length = ftell(fp) / 188 * 188;
+        fseek(fp, 0, SEEK_SET);
+        loop.resize(length);
+        if (length > 0 && fread(&loop[0], 1, length, fp) != length) {
+          length = 0;
+        }
+        fclose(fp);
+      }
+      if (length == 0) {
+        GR_LOG_FATAL(d_logger, "Loop Playout, cannot read TS packets from " + tsfile);
+        throw std::runtime_error("Loop Playout, cannot read TS packets from " + tsfile);
+      }
+    }
+
+    /* The TS starting at byte pos of the loop, played over and over */
+    void
+    loopplayout_c_impl::fill_input(const std::vector<unsigned char> &loop, uint64_t pos, std::vector<unsigned char> &ts)
+    {
+      size_t offset = pos % loop.size();
+      size_t done = 0;
+      size_t run;
+
+      while (done < ts.size()) {
+        run = std::min(ts.size() - done, loop.size() - offset);
+        memcpy(&ts[done], &loop[offset], run);
+        done += run;
+        offset = 0;
+      }
+    }
+
+    /* Maps cache_file if it holds the I/Q for the current checksum */
+    bool
+    loopplayout_c_impl::open_cache(void)
+    {
+      const cache_header *header;
+      struct stat st;
+      void *map;
+      int fd;
+
+      if (cache_file.empty()) {
+        return false;
+      }
+      fd = open(cache_file.c_str(), O_RDONLY);
+      if (fd < 0) {
+        return false;
+      }
+      if (fstat(fd, &st) != 0 || st.st_size < CACHE_HEADER_SIZE) {
+        close(fd);
+        return false;
+      }
+      map = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+      close(fd);
+      if (map == MAP_FAILED) {
+        return false;
+      }
+      header = (const cache_header *)map;
+      if (memcmp(header->magic, CACHE_MAGIC, sizeof(header->magic)) != 0 ||
+          header->version != CACHE_VERSION || header->checksum != checksum ||
+          header->frames == 0 ||
+          (uint64_t)st.st_size != CACHE_HEADER_SIZE + (header->frames * header->frame_items * sizeof(gr_complex))) {
+        munmap(map, st.st_size);
+        GR_LOG_INFO(d_logger, "Loop Playout, " + cache_file + " is out of date, encoding again.");
+        return false;
+      }
+      cache = map;
+      cache_size = st.st_size;
+      samples = (const gr_complex *)((const char *)map + CACHE_HEADER_SIZE);
+      total_items = header->frames * header->frame_items;
+      posix_madvise(cache, cache_size, POSIX_MADV_WILLNEED);
+      GR_LOG_INFO(d_logger, "Loop Playout, playing " + std::to_string(header->frames) + " T2 frames from " + cache_file + ".");
+      return true;
+    }
+
+    /*
+     * Maps a new cache of size bytes, a temporary file next to
+     * cache_file (fd is set) or anonymous memory (fd is -1).
+     */
+    void *
+    loopplayout_c_impl::create_cache(size_t size, int &fd)
+    {
+      void *map;
+
+      fd = -1;
+      if (!cache_file.empty()) {
+        fd = open((cache_file + ".tmp").c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd >= 0 && ftruncate(fd, size) != 0) {
+          close(fd);
+          unlink((cache_file + ".tmp").c_str());
+          fd = -1;
+        }
+        if (fd < 0) {
+          GR_LOG_WARN(d_logger, "Loop Playout, cannot write " + cache_file + ", the I/Q is kept in memory only.");
+        }
+      }
+      if (fd >= 0) {
+        map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+      }
+      else {
+        map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      }
+      if (map == MAP_FAILED) {
+        if (fd >= 0) {
+          close(fd);
+          unlink((cache_file + ".tmp").c_str());
+        }
+        GR_LOG_FATAL(d_logger, "Loop Playout, cannot allocate memory for the I/Q cache.");
+        throw std::bad_alloc();
+      }
+      return map;
+    }
+
+    /*
+     * Encodes the loop into a new cache. The loop length is found by
+     * stepping the TS position through the BBFRAMEs without encoding
+     * them. When the loop lines up, the encoder goes once around it
+     * before the first frame is kept, so the CRC-8 of the first packet
+     * covers the last packet of the loop as it will on the air: frame
+     * 0 is encoded last, as frame number frames.
+     */
+    void
+    loopplayout_c_impl::build_cache(const std::vector<unsigned char> &loop, bbframe_encoder_impl &encoder, cell_modulator_impl &modulator, frame_mapper_impl &mapper, ofdm_modulator_impl &ofdm, int fec_blocks, int t2_frames, int max_frames)
+    {
+      std::vector<unsigned char> ts;
+      std::vector<unsigned char> fec(fec_blocks * encoder.frame_bits());
+      std::vector<gr_complex> cells(fec_blocks * modulator.output_items());
+      std::vector<gr_complex> mapped(mapper.output_items());
+      uint64_t frame_items = ofdm.output_items();
+      unsigned int ts_count = 0;
+      int fec_block = 0;
+      uint64_t pos = 0;
+      int frames = 0;
+      int first = 1;
+      cache_header *header;
+      gr_complex *out;
+      int fd;
+
+      for (int f = 1; f <= max_frames && frames == 0; f++) {
+        for (int b = 0; b < fec_blocks; b++) {
+          pos += encoder.frame_input_items(ts_count, fec_block);
+        }
+        pos %= loop.size();
+        if (f % t2_frames == 0 && pos == 0) {
+          frames = f;
+        }
+      }
+      if (frames == 0) {
+        frames = max_frames / t2_frames * t2_frames;
+        first = 0;
+        GR_LOG_WARN(d_logger, "Loop Playout, the TS loop doesn't end on a super-frame within " + std::to_string(max_frames) + " T2 frames, the TS jumps back every " + std::to_string(frames) + " frames.");
+      }
+
+      cache_size = CACHE_HEADER_SIZE + (frames * frame_items * sizeof(gr_complex));
+      cache = create_cache(cache_size, fd);
+      out = (gr_complex *)((char *)cache + CACHE_HEADER_SIZE);
+
+      pos = 0;
+      if (first == 1) {
+        ts.resize(encoder.input_items(fec_blocks));
+        fill_input(loop, pos, ts);
+        for (int b = 0; b < fec_blocks; b++) {
+          pos += encoder.encode_frame(&ts[pos], &fec[b * encoder.frame_bits()]);
+        }
+        mapper.skip_frames(1);
+      }
+      for (int f = first; f < first + frames; f++) {
+        ts.resize(encoder.input_items(fec_blocks));
+        fill_input(loop, pos, ts);
+        pos += encoder.process(&ts[0], &fec[0], fec_blocks);
+        modulator.process(&fec[0], &cells[0], fec_blocks);
+        mapper.process(&cells[0], &mapped[0], 1);
+        ofdm.process(&mapped[0], &out[(f % frames) * frame_items], 1);
+      }
+      if (encoder.sync_errors() > 0) {
+        GR_LOG_WARN(d_logger, "Transport Stream sync error!");
+      }
+
+      header = (cache_header *)cache;
+      memcpy(header->magic, CACHE_MAGIC, sizeof(header->magic));
+      header->version = CACHE_VERSION;
+      header->checksum = checksum;
+      header->frames = frames;
+      header->frame_items = frame_items;
+      if (fd >= 0) {
+        if (msync(cache, cache_size, MS_SYNC) != 0 || rename((cache_file + ".tmp").c_str(), cache_file.c_str()) != 0) {
+          unlink((cache_file + ".tmp").c_str());
+          GR_LOG_WARN(d_logger, "Loop Playout, cannot write " + cache_file + ", the I/Q is kept in memory only.");
+        }
+        close(fd);
+      }
+      samples = out;
+      total_items = frames * frame_items;
+      GR_LOG_INFO(d_logger, "Loop Playout, encoded " + std::to_string(frames) + " T2 frames.");
+    }
+
+    int
+    loopplayout_c_impl::work(int noutput_items,
+                       gr_vector_const_void_star &,
+                       gr_vector_void_star &output_items)
+    {
+      gr_complex *out = (gr_complex *) output_items[0];
+      int produced = 0;
+      int run;
+
+      while (produced < noutput_items) {
+        run = std::min((uint64_t)(noutput_items - produced), total_items - position);
+        memcpy(&out[produced], &samples[position], run * sizeof(gr_complex));
+        produced += run;
+        position = (position + run) % total_items;
+      }
+
+      // Tell runtime system how many output items we produced.
+      return noutput_items;
+    }
+
+  } /* namespace dvbt2ll */
+} /* namespace gr */
+
@@ -0,0 +1,81 @@
+/* -*- c++ -*- */
+/* 
+ * Copyright 2017 Ron Economos.
+ * 
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ * 
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_DVBT2LL_LOOPPLAYOUT_C_IMPL_H
+#define INCLUDED_DVBT2LL_LOOPPLAYOUT_C_IMPL_H
+
+#include <dvbt2ll/loopplayout_c.h>
+#include "bbframe_encoder_impl.h"
+#include "cell_modulator_impl.h"
+#include "frame_mapper_impl.h"
+#include "ofdm_modulator_impl.h"
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#define CACHE_MAGIC "DVBT2LLC"
+/* Bump when the cache layout or the encoded signal changes */
+#define CACHE_VERSION 1
+/* The samples start a page in, so they are aligned in the mapping */
+#define CACHE_HEADER_SIZE 4096
+
+namespace gr {
+  namespace dvbt2ll {
+
+    class loopplayout_c_impl : public loopplayout_c
+    {
+     private:
+      struct cache_header
+      {
+        char magic[8];
+        uint32_t version;
+        uint32_t checksum;
+        uint64_t frames;
+        uint64_t frame_items;
+      };
+
+      std::string cache_file;
+      uint32_t checksum;
+      void *cache;
+      size_t cache_size;
+      const gr_complex *samples;
+      uint64_t total_items;
+      uint64_t position;
+
+      void read_loop(const std::string &, std::vector<unsigned char> &);
+      void fill_input(const std::vector<unsigned char> &, uint64_t, std::vector<unsigned char> &);
+      bool open_cache(void);
+      void *create_cache(size_t, int &);
+      void build_cache(const std::vector<unsigned char> &, bbframe_encoder_impl &, cell_modulator_impl &, frame_mapper_impl &, ofdm_modulator_impl &, int, int, int);
+
+     public:
+      loopplayout_c_impl(const std::string &tsfile, const std::string &cachefile, dvbt2_framesize_t framesize, dvbt2_code_rate_t rate, dvbt2_constellation_t constellation, dvbt2_rotation_t rotation, int fecblocks, int tiblocks, dvbt2_extended_carrier_t carriermode, dvbt2_fftsize_t fftsize, dvbt2_guardinterval_t guardinterval, dvbt2_l1constellation_t l1constellation, dvbt2_pilotpattern_t pilotpattern, int t2frames, int numdatasyms, dvbt2_papr_t paprmode, dvbt2_version_t version, dvbt2_preamble_t preamble, dvbt2_inputmode_t inputmode, dvbt2_reservedbiasbits_t reservedbiasbits, dvbt2_l1scrambled_t l1scrambled, dvbt2_inband_t inband, int tsrate, dvbt2_misogroup_t misogroup, dvbt2_equalization_t equalization, dvbt2_bandwidth_t bandwidth, int vlength, int maxframes);
+      ~loopplayout_c_impl();
+
+      int work(int noutput_items,
+           gr_vector_const_void_star &input_items,
+           gr_vector_void_star &output_items);
+    };
+
+  } // namespace dvbt2ll
+} // namespace gr
+
+#endif /* INCLUDED_DVBT2LL_LOOPPLAYOUT_C_IMPL_H */
+
@@ -0,0 +1,32 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2017 Ron Economos.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_DVBT2LL_MODCOD_TAG_H
+#define INCLUDED_DVBT2LL_MODCOD_TAG_H
+
+/*
+ * Key of the stream tag interleavermod_bc puts on the first cell it
+ * maps with the constellation of a modcod message. The value is the
+ * new constellation. framemapperfint_cc only switches to the new
+ * configuration at a cell with this tag.
+ */
+#define MODCOD_TAG "modcod"
+
+#endif /* INCLUDED_DVBT2LL_MODCOD_TAG_H */
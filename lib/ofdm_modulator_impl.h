@@ -0,0 +1,242 @@
+/* -*- c++ -*- */
+/* 
+ * Copyright 2017 Ron Economos.
+ * 
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ * 
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_DVBT2LL_OFDM_MODULATOR_IMPL_H
+#define INCLUDED_DVBT2LL_OFDM_MODULATOR_IMPL_H
+
+#include <dvbt2ll/ofdm_modulator.h>
+#include <gnuradio/fft/fft.h>
+#include "dvbt2_tables.h"
+#include "table_cache.h"
+#include "frame_buffer.h"
+#include <boost/tuple/tuple.hpp>
+#include <boost/tuple/tuple_comparison.hpp>
+#include <vector>
+
+#define CHIPS 2624
+#define MAX_CARRIERS 27841
+
+enum dvbt2_carrier_type_t {
+  DATA_CARRIER = 1,
+  P2PILOT_CARRIER,
+  P2PAPR_CARRIER,
+  TRPAPR_CARRIER,
+  SCATTERED_CARRIER,
+  CONTINUAL_CARRIER,
+  P2PILOT_CARRIER_INVERTED,
+  SCATTERED_CARRIER_INVERTED,
+  CONTINUAL_CARRIER_INVERTED
+};
+
+namespace gr {
+  namespace dvbt2ll {
+
+    class DVBT2LL_CORE_API ofdm_modulator_impl : public ofdm_modulator
+    {
+     private:
+      int active_items;
+      int num_symbols;
+      int fft_size;
+      int left_nulls;
+      int right_nulls;
+      int pilot_pattern;
+      int carrier_mode;
+      int papr_mode;
+      int equalization_enable;
+      int guard_interval;
+      float normalization;
+      gr_complex p2_bpsk[2];
+      gr_complex sp_bpsk[2];
+      gr_complex cp_bpsk[2];
+      gr_complex p2_bpsk_inverted[2];
+      gr_complex sp_bpsk_inverted[2];
+      gr_complex cp_bpsk_inverted[2];
+      gr_complex *fft_buffer;
+      gr_complex *fft_buffer2;
+      int p2_carrier_map[MAX_CARRIERS];
+      int data_carrier_map[MAX_CARRIERS];
+      int fc_carrier_map[MAX_CARRIERS];
+      int N_P2;
+      int C_P2;
+      int N_FC;
+      int C_FC;
+      int C_DATA;
+      int K_EXT;
+      int C_PS;
+      int K_OFFSET;
+      int dx;
+      int dy;
+      int miso;
+      int miso_group;
+      bool dual;
+      int frame_items;
+
+      /*
+       * P1 symbols and inverse sinc tables, shared by all instances
+       * with the same parameters.
+       */
+      struct p1_tables
+      {
+        gr_complex p1_time[1024];
+        gr_complex p1_timeshft[1024];
+      };
+      typedef boost::tuple<int, int> p1_key;
+      typedef boost::tuple<int, int> sinc_key;
+      static table_cache<p1_key, p1_tables> p1_cache;
+      static table_cache<sinc_key, std::vector<gr_complex> > sinc_cache;
+      boost::shared_ptr<const p1_tables> p1;
+      boost::shared_ptr<const std::vector<gr_complex> > inverse_sinc;
+      p1_tables *build_p1_tables(int, int);
+      std::vector<gr_complex> *build_inverse_sinc(int, int);
+
+      void init_pilots(int);
+      template <class T> const T *assemble_cells(int, const T *);
+      template <class T> const T *assemble_pair(int, const T *);
+      void load_fft(const gr_complex *);
+      void copy_symbol(const gr_complex *, gr_complex *);
+      void copy_symbol(const gr_complex *, lv_16sc_t *);
+
+      fft::fft_complex *ofdm_fft;
+      int ofdm_fft_size;
+
+      const static unsigned char pn_sequence_table[CHIPS / 8];
+      const static int p2_papr_map_1k[10];
+      const static int p2_papr_map_2k[18];
+      const static int p2_papr_map_4k[36];
+      const static int p2_papr_map_8k[72];
+      const static int p2_papr_map_16k[144];
+      const static int p2_papr_map_32k[288];
+      const static int tr_papr_map_1k[10];
+      const static int tr_papr_map_2k[18];
+      const static int tr_papr_map_4k[36];
+      const static int tr_papr_map_8k[72];
+      const static int tr_papr_map_16k[144];
+      const static int tr_papr_map_32k[288];
+      const static int pp1_cp1[20];
+      const static int pp1_cp2[25];
+      const static int pp1_cp5[44];
+      const static int pp2_cp1[20];
+      const static int pp2_cp2[22];
+      const static int pp2_cp3[2];
+      const static int pp2_cp4[2];
+      const static int pp2_cp5[41];
+      const static int pp2_cp6[88];
+      const static int pp3_cp1[22];
+      const static int pp3_cp2[20];
+      const static int pp3_cp3[1];
+      const static int pp3_cp5[44];
+      const static int pp3_cp6[49];
+      const static int pp4_cp1[20];
+      const static int pp4_cp2[23];
+      const static int pp4_cp3[1];
+      const static int pp4_cp4[2];
+      const static int pp4_cp5[44];
+      const static int pp4_cp6[86];
+      const static int pp5_cp1[19];
+      const static int pp5_cp2[23];
+      const static int pp5_cp3[3];
+      const static int pp5_cp4[1];
+      const static int pp5_cp5[44];
+      const static int pp6_cp5[88];
+      const static int pp6_cp6[88];
+      const static int pp7_cp1[15];
+      const static int pp7_cp2[30];
+      const static int pp7_cp3[5];
+      const static int pp7_cp4[3];
+      const static int pp7_cp5[35];
+      const static int pp7_cp6[92];
+      const static int pp8_cp4[47];
+      const static int pp8_cp5[39];
+      const static int pp8_cp6[89];
+      const static int pp2_8k[4];
+      const static int pp3_8k[2];
+      const static int pp4_8k[2];
+      const static int pp7_8k[5];
+      const static int pp8_8k[5];
+      const static int pp1_16k[4];
+      const static int pp2_16k[2];
+      const static int pp3_16k[2];
+      const static int pp4_16k[2];
+      const static int pp5_16k[2];
+      const static int pp6_16k[2];
+      const static int pp7_16k[3];
+      const static int pp8_16k[3];
+      const static int pp2_32k[2];
+      const static int pp4_32k[2];
+      const static int pp6_32k[4];
+      const static int pp7_32k[2];
+      const static int pp8_32k[6];
+
+
+      const static int p1_active_carriers[384];
+      const static unsigned char s1_modulation_patterns[8][8];
+      const static unsigned char s2_modulation_patterns[16][32];
+
+     public:
+      ofdm_modulator_impl(dvbt2_extended_carrier_t carriermode, dvbt2_fftsize_t fftsize, dvbt2_pilotpattern_t pilotpattern, dvbt2_guardinterval_t guardinterval, int numdatasyms, dvbt2_papr_t paprmode, dvbt2_version_t version, dvbt2_preamble_t preamble, dvbt2_misogroup_t misogroup, dvbt2_equalization_t equalization, dvbt2_bandwidth_t bandwidth, int vlength);
+      ~ofdm_modulator_impl();
+
+      int input_items() const { return active_items; }
+      int output_items() const { return frame_items; }
+      int process(const gr_complex *, gr_complex *, int);
+      int process(const lv_16sc_t *, lv_16sc_t *, int);
+      int process(const gr_complex *, gr_complex *, gr_complex *, int);
+      int process(const lv_16sc_t *, lv_16sc_t *, lv_16sc_t *, int);
+
+      /* MISO_TX1_TX2, two outputs */
+      bool dual_output() const { return dual; }
+
+      /* OFDM symbols per T2 frame (without P1), their cells and samples */
+      int symbols() const { return num_symbols; }
+      int symbol_cells(int symbol) const;
+      int symbol_items() const { return ofdm_fft_size + guard_interval; }
+
+      /* The 2048 samples of the P1 symbol */
+      void add_p1(gr_complex *);
+      void add_p1(lv_16sc_t *);
+
+      /*
+       * Builds one OFDM symbol (with guard interval) from the cells at
+       * in and returns the new input position. The three steps of
+       * modulate_symbol() are there for timing them apart. The sc16
+       * overloads take Q2.13 cells and write sc16 I/Q, the ones with
+       * out2 write both MISO groups.
+       */
+      const gr_complex *modulate_symbol(int, const gr_complex *, gr_complex *);
+      const lv_16sc_t *modulate_symbol(int, const lv_16sc_t *, lv_16sc_t *);
+      const gr_complex *assemble_symbol(int, const gr_complex *);
+      const lv_16sc_t *assemble_symbol(int, const lv_16sc_t *);
+      void transform_symbol(void);
+      void add_guard(gr_complex *);
+      void add_guard(lv_16sc_t *);
+      void add_guard(gr_complex *, gr_complex *);
+      void add_guard(lv_16sc_t *, lv_16sc_t *);
+
+      /* A whole T2 frame, P1 symbol included */
+      void modulate_frame(const gr_complex *, gr_complex *);
+      void modulate_frame(const lv_16sc_t *, lv_16sc_t *);
+      void modulate_frame(const gr_complex *, gr_complex *, gr_complex *);
+      void modulate_frame(const lv_16sc_t *, lv_16sc_t *, lv_16sc_t *);
+    };
+
+  } // namespace dvbt2ll
+} // namespace gr
+
+#endif /* INCLUDED_DVBT2LL_OFDM_MODULATOR_IMPL_H */
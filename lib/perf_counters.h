@@ -0,0 +1,140 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2017 Ron Economos.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_DVBT2LL_PERF_COUNTERS_H
+#define INCLUDED_DVBT2LL_PERF_COUNTERS_H
+
+#include <gnuradio/high_res_timer.h>
+#include <pmt/pmt.h>
+#include <string>
+#include <vector>
+
+/* Message port every block publishes its counters on */
+#define PERF_PORT "perf"
+
+/* Seconds between two messages on the perf port */
+#define PERF_INTERVAL 1.0
+
+namespace gr {
+  namespace dvbt2ll {
+
+    /*
+     * Hot path counters of one block. They are only touched from
+     * general_work(), which also publishes them, so plain integers are
+     * enough and a stage costs two gr::high_res_timer_now() calls.
+     *
+     * The message is a dict with the running totals "frames", "calls"
+     * and "starved" (calls that left less than one frame of input, so
+     * the block waits on its upstream next), "load" (time spent in
+     * general_work() over wall time) and "<stage>_ns", the time per
+     * frame of every stage, both over the last interval. A block that
+     * isn't called isn't published either.
+     */
+    class perf_counters
+    {
+     private:
+      std::vector<pmt::pmt_t> d_keys;
+      std::vector<gr::high_res_timer_type> d_ticks;
+      gr::high_res_timer_type d_busy;
+      gr::high_res_timer_type d_last;
+      uint64_t d_frames;
+      uint64_t d_interval_frames;
+      uint64_t d_calls;
+      uint64_t d_starved;
+
+     public:
+      perf_counters()
+        : d_busy(0), d_last(0), d_frames(0), d_interval_frames(0),
+          d_calls(0), d_starved(0) {}
+
+      /* Returns the index to pass to add() and lap() */
+      int add_stage(const std::string &name)
+      {
+        d_keys.push_back(pmt::mp(name + "_ns"));
+        d_ticks.push_back(0);
+        return d_keys.size() - 1;
+      }
+
+      /* Charges time that was measured in another thread */
+      void add(int stage, gr::high_res_timer_type ticks)
+      {
+        d_ticks[stage] += ticks;
+      }
+
+      /* Charges the time since mark to stage and moves mark to now */
+      void lap(int stage, gr::high_res_timer_type &mark)
+      {
+        gr::high_res_timer_type now = gr::high_res_timer_now();
+
+        d_ticks[stage] += now - mark;
+        mark = now;
+      }
+
+      void frames(int count)
+      {
+        d_frames += count;
+        d_interval_frames += count;
+      }
+
+      void starved() { d_starved++; }
+
+      /*
+       * Ends a call that started at start. Returns true when the
+       * counters are due to be published with report().
+       */
+      bool end_call(gr::high_res_timer_type start, gr::high_res_timer_type now)
+      {
+        d_calls++;
+        d_busy += now - start;
+        if (d_last == 0) {
+          d_last = start;
+        }
+        return (now - d_last) >= (gr::high_res_timer_type)(PERF_INTERVAL * gr::high_res_timer_tps());
+      }
+
+      /* Builds the message and starts a new interval */
+      pmt::pmt_t report(gr::high_res_timer_type now)
+      {
+        double tps = gr::high_res_timer_tps();
+        pmt::pmt_t msg = pmt::make_dict();
+
+        msg = pmt::dict_add(msg, pmt::mp("frames"), pmt::from_uint64(d_frames));
+        msg = pmt::dict_add(msg, pmt::mp("calls"), pmt::from_uint64(d_calls));
+        msg = pmt::dict_add(msg, pmt::mp("starved"), pmt::from_uint64(d_starved));
+        msg = pmt::dict_add(msg, pmt::mp("load"), pmt::from_double((double)d_busy / (double)(now - d_last)));
+        for (size_t i = 0; i < d_keys.size(); i++) {
+          double ns = 0.0;
+          if (d_interval_frames > 0) {
+            ns = (double)d_ticks[i] * 1e9 / tps / d_interval_frames;
+          }
+          msg = pmt::dict_add(msg, d_keys[i], pmt::from_double(ns));
+          d_ticks[i] = 0;
+        }
+        d_busy = 0;
+        d_interval_frames = 0;
+        d_last = now;
+        return msg;
+      }
+    };
+
+  } // namespace dvbt2ll
+} // namespace gr
+
+#endif /* INCLUDED_DVBT2LL_PERF_COUNTERS_H */
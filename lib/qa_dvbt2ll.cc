@@ -26,11 +26,13 @@
  */
 
 #include "qa_dvbt2ll.h"
+#include "qa_golden_vectors.h"
 
 CppUnit::TestSuite *
 qa_dvbt2ll::suite()
 {
   CppUnit::TestSuite *s = new CppUnit::TestSuite("dvbt2ll");
+  s->addTest(gr::dvbt2ll::qa_golden_vectors::suite());
 
   return s;
 }
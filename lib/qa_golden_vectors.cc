@@ -0,0 +1,1740 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2017 Ron Economos.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "qa_golden_vectors.h"
+#include <cppunit/TestAssert.h>
+#include <gnuradio/block_detail.h>
+#include <gnuradio/buffer.h>
+#include <dvbt2ll/bbheaderbch_bb.h>
+#include <dvbt2ll/interleavermod_bc.h>
+#include <dvbt2ll/framemapperfint_cc.h>
+#include <dvbt2ll/pilotgenp1insert_cc.h>
+#include <dvbt2ll/transmitter_bc.h>
+#include <dvbt2ll/bbframe_encoder.h>
+#include <dvbt2ll/cell_modulator.h>
+#include <dvbt2ll/frame_mapper.h>
+#include <dvbt2ll/ofdm_modulator.h>
+#include <dvbt2ll/loopplayout_c.h>
+#include <dvbt2ll/t2miencap_bb.h>
+#include "cpu_dispatch.h"
+#include "frame_buffer.h"
+#include "sc16_cells.h"
+#include "ofdm_modulator_impl.h"
+#include "t2miencap_bb_impl.h"
+#include <algorithm>
+#include <chrono>
+#include <vector>
+#include <cmath>
+#include <stdexcept>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* FEC blocks or T2 frames run through each configuration */
+#define GOLDEN_FRAMES 2
+/* Leading output items kept in full, to locate a hash mismatch */
+#define HEAD_LENGTH 32
+/* Output samples kept per pilot generator configuration */
+#define PILOT_SAMPLES 32
+/* Allowed error after the IFFT, relative to the RMS of the frame */
+#define PILOT_TOLERANCE 1e-3
+/* Stage thread counts the transmitter is run with */
+#define TRANSMITTER_THREADS 3
+/* TS packets in the loop of the playout test and T2 frames played */
+#define PLAYOUT_PACKETS 4
+#define PLAYOUT_FRAMES 100
+/*
+ * Lowest MER of the Q2.13 cells and SNR of the sc16 I/Q, in dB. The
+ * I/Q is about 84 dB, unless one of the rare peaks more than 12 dB
+ * over the RMS is clipped, which takes it down to about 55 dB.
+ */
+#define SC16_CELL_MER 80.0
+#define SC16_IQ_SNR 50.0
+/* T2-MI PID of the encapsulator test */
+#define T2MI_PID 4096
+
+namespace gr {
+  namespace dvbt2ll {
+
+    struct bbheader_config
+    {
+      dvbt2_framesize_t framesize;
+      dvbt2_code_rate_t rate;
+      dvbt2_inputmode_t mode;
+      dvbt2_inband_t inband;
+      int fecblocks;
+      int tsrate;
+    };
+
+    static const bbheader_config bbheader_configs[] = {
+      {FECFRAME_NORMAL, C1_2, INPUTMODE_NORMAL, INBAND_OFF, 1, 0},
+      {FECFRAME_NORMAL, C3_5, INPUTMODE_NORMAL, INBAND_OFF, 1, 0},
+      {FECFRAME_NORMAL, C2_3, INPUTMODE_NORMAL, INBAND_OFF, 1, 0},
+      {FECFRAME_NORMAL, C3_4, INPUTMODE_NORMAL, INBAND_OFF, 1, 0},
+      {FECFRAME_NORMAL, C4_5, INPUTMODE_NORMAL, INBAND_OFF, 1, 0},
+      {FECFRAME_NORMAL, C5_6, INPUTMODE_NORMAL, INBAND_OFF, 1, 0},
+      {FECFRAME_SHORT, C1_3, INPUTMODE_NORMAL, INBAND_OFF, 1, 0},
+      {FECFRAME_SHORT, C2_5, INPUTMODE_NORMAL, INBAND_OFF, 1, 0},
+      {FECFRAME_SHORT, C1_2, INPUTMODE_NORMAL, INBAND_OFF, 1, 0},
+      {FECFRAME_SHORT, C3_5, INPUTMODE_NORMAL, INBAND_OFF, 1, 0},
+      {FECFRAME_SHORT, C2_3, INPUTMODE_NORMAL, INBAND_OFF, 1, 0},
+      {FECFRAME_SHORT, C3_4, INPUTMODE_NORMAL, INBAND_OFF, 1, 0},
+      {FECFRAME_SHORT, C4_5, INPUTMODE_NORMAL, INBAND_OFF, 1, 0},
+      {FECFRAME_SHORT, C5_6, INPUTMODE_NORMAL, INBAND_OFF, 1, 0},
+      {FECFRAME_NORMAL, C2_3, INPUTMODE_HIEFF, INBAND_OFF, 1, 0},
+      {FECFRAME_SHORT, C3_4, INPUTMODE_HIEFF, INBAND_OFF, 1, 0},
+      {FECFRAME_NORMAL, C3_5, INPUTMODE_NORMAL, INBAND_ON, 2, 30000000},
+      {FECFRAME_NORMAL, C3_5, INPUTMODE_HIEFF, INBAND_ON, 2, 30000000},
+    };
+
+    struct interleavermod_config
+    {
+      dvbt2_framesize_t framesize;
+      dvbt2_code_rate_t rate;
+    };
+
+    static const interleavermod_config interleavermod_configs[] = {
+      {FECFRAME_NORMAL, C1_2},
+      {FECFRAME_NORMAL, C3_5},
+      {FECFRAME_NORMAL, C2_3},
+      {FECFRAME_NORMAL, C3_4},
+      {FECFRAME_NORMAL, C4_5},
+      {FECFRAME_NORMAL, C5_6},
+      {FECFRAME_SHORT, C1_3},
+      {FECFRAME_SHORT, C2_5},
+      {FECFRAME_SHORT, C1_2},
+      {FECFRAME_SHORT, C3_5},
+      {FECFRAME_SHORT, C2_3},
+      {FECFRAME_SHORT, C3_4},
+      {FECFRAME_SHORT, C4_5},
+      {FECFRAME_SHORT, C5_6},
+    };
+
+    /* Every code rate runs with each constellation, without and with rotation */
+    #define INTERLEAVERMOD_MODES 8
+
+    struct frame_config
+    {
+      dvbt2_framesize_t framesize;
+      dvbt2_code_rate_t rate;
+      dvbt2_constellation_t constellation;
+      int fecblocks;
+      int tiblocks;
+      dvbt2_extended_carrier_t carriermode;
+      dvbt2_fftsize_t fftsize;
+      dvbt2_guardinterval_t guardinterval;
+      dvbt2_l1constellation_t l1constellation;
+      dvbt2_pilotpattern_t pilotpattern;
+      int t2frames;
+      int numdatasyms;
+      dvbt2_papr_t paprmode;
+      dvbt2_preamble_t preamble;
+      dvbt2_l1scrambled_t l1scrambled;
+      dvbt2_equalization_t equalization;
+      dvbt2_bandwidth_t bandwidth;
+      int vlength;
+    };
+
+    static const frame_config frame_configs[] = {
+      {FECFRAME_SHORT, C1_2, MOD_QPSK, 4, 1, CARRIERS_NORMAL, FFTSIZE_4K, GI_1_32, L1_MOD_16QAM, PILOT_PP7, 2, 100, PAPR_OFF, PREAMBLE_T2_SISO, L1_SCRAMBLED_OFF, EQUALIZATION_ON, BANDWIDTH_8_0_MHZ, 4096},
+      {FECFRAME_SHORT, C1_2, MOD_16QAM, 8, 3, CARRIERS_NORMAL, FFTSIZE_1K, GI_1_8, L1_MOD_BPSK, PILOT_PP1, 3, 60, PAPR_OFF, PREAMBLE_T2_SISO, L1_SCRAMBLED_ON, EQUALIZATION_OFF, BANDWIDTH_1_7_MHZ, 1024},
+      {FECFRAME_NORMAL, C2_3, MOD_256QAM, 20, 3, CARRIERS_EXTENDED, FFTSIZE_32K, GI_1_128, L1_MOD_64QAM, PILOT_PP7, 2, 59, PAPR_TR, PREAMBLE_T2_SISO, L1_SCRAMBLED_OFF, EQUALIZATION_ON, BANDWIDTH_8_0_MHZ, 32768},
+      {FECFRAME_NORMAL, C3_4, MOD_64QAM, 10, 0, CARRIERS_NORMAL, FFTSIZE_8K, GI_1_32, L1_MOD_QPSK, PILOT_PP4, 4, 60, PAPR_OFF, PREAMBLE_T2_MISO, L1_SCRAMBLED_OFF, EQUALIZATION_ON, BANDWIDTH_7_0_MHZ, 8192},
+      {FECFRAME_NORMAL, C1_2, MOD_QPSK, 5, 2, CARRIERS_NORMAL, FFTSIZE_16K, GI_1_16, L1_MOD_16QAM, PILOT_PP2, 1, 40, PAPR_OFF, PREAMBLE_T2_SISO, L1_SCRAMBLED_OFF, EQUALIZATION_ON, BANDWIDTH_8_0_MHZ, 16384},
+      {FECFRAME_SHORT, C1_2, MOD_64QAM, 12, 2, CARRIERS_NORMAL, FFTSIZE_2K, GI_1_4, L1_MOD_64QAM, PILOT_PP1, 3, 80, PAPR_OFF, PREAMBLE_T2_SISO, L1_SCRAMBLED_OFF, EQUALIZATION_ON, BANDWIDTH_5_0_MHZ, 2048},
+    };
+
+    /*
+     * With 75 short FEC blocks at rate 1/2 a T2-MI packet starts on
+     * the last payload byte of a TS packet, which takes the one byte
+     * adaptation field.
+     */
+    static const frame_config t2mi_configs[] = {
+      {FECFRAME_SHORT, C1_2, MOD_16QAM, 75, 3, CARRIERS_EXTENDED, FFTSIZE_32K, GI_1_128, L1_MOD_64QAM, PILOT_PP7, 2, 59, PAPR_OFF, PREAMBLE_T2_SISO, L1_SCRAMBLED_OFF, EQUALIZATION_ON, BANDWIDTH_8_0_MHZ, 32768},
+    };
+
+    /*
+     * Reference outputs, recorded with DVBT2LL_GOLDEN_RECORD=1. The
+     * hashes are 64-bit FNV-1a over the raw output of GOLDEN_FRAMES
+     * frames, the head vectors are the first outputs of the first
+     * configuration of each table. They were recorded after the L1
+     * caches, the LDPC and BCH rework, the SIMD kernels and the
+     * precomputed cell map went in, not from the original scalar
+     * code. That code gives the same output bit for bit for the
+     * configurations its blocks support.
+     */
+    static const uint64_t bbheader_hashes[] = {
+      0x0cf00549a349b575ULL,
+      0x6ec94608b723c31cULL,
+      0x087d6558bf0be12dULL,
+      0xfc5bc5d6e7f33428ULL,
+      0x670546d90d052108ULL,
+      0x55ed90bee530b737ULL,
+      0xf76fd6b23ded65beULL,
+      0x44bf6572f9729ed7ULL,
+      0xe8eecb5f8fc84b20ULL,
+      0x07d6bf97d6b65f38ULL,
+      0x1baabf4d428d9c3aULL,
+      0xafc075e8c2d42489ULL,
+      0x0d9c70fd1ba1f034ULL,
+      0x3fd37563b7e26ebdULL,
+      0xaf65fe74c9f10e2aULL,
+      0x51b49998190b991fULL,
+      0xee02c9ad5c4b9b21ULL,
+      0xe38d2aa822013d95ULL,
+    };
+
+    static const unsigned char bbheader_head[HEAD_LENGTH] = {
+      1, 1, 1, 1, 0, 0, 1, 1, 1, 1, 1, 1, 0, 1, 1, 0, 0, 0, 0, 0, 1, 1, 0, 1, 1, 1, 0, 1, 0, 1, 0, 0,
+    };
+
+    static const uint64_t interleavermod_hashes[] = {
+      0x78e9762afab736a5ULL,
+      0x8658dafbf98e77edULL,
+      0x2fb32b887b92a6cfULL,
+      0xbc542b593bd6140aULL,
+      0x42d5779398f280b0ULL,
+      0x27581d9b7c53c6cfULL,
+      0x7de3a9b7c4ae096bULL,
+      0x06fa0dbafda071f5ULL,
+      0xdcd003ac3dc8d625ULL,
+      0x9c416ae505f3b1d5ULL,
+      0xc873779f0ac10ad1ULL,
+      0xbeb98fe1491143fdULL,
+      0x985da39538c5dfbdULL,
+      0x28d6880aec4e1aefULL,
+      0x4d86323c0863c6d4ULL,
+      0xe727a33ec1f52e15ULL,
+      0x3aaa1c4b3ea174a5ULL,
+      0x2b0c82ac1e01c4edULL,
+      0xda04eb7db5b91f95ULL,
+      0x18c5b7af9793b759ULL,
+      0xba55aba77b69be04ULL,
+      0xa54657612f7bf2b6ULL,
+      0x0c52696137cab2d5ULL,
+      0xb7448b33f042d2dcULL,
+      0x134dc3217d550ca5ULL,
+      0x1ea82426eb02208dULL,
+      0x31a87c4e2bb94e61ULL,
+      0x445e6dbcfc7ed41dULL,
+      0xd5347e8557cf6b3dULL,
+      0x1e16cdedeaaf2cb7ULL,
+      0x8cd66a2736146703ULL,
+      0x176acc41a414f36cULL,
+      0x06288cc01b52cb25ULL,
+      0x891390eeb9cceabdULL,
+      0x8b8805514455d9f7ULL,
+      0xba4a165277ed1f12ULL,
+      0x29adfa7c80b68d59ULL,
+      0xaebc421ad248902fULL,
+      0xb86c865b1a1f76b1ULL,
+      0x3bdcc2a409aeec42ULL,
+      0x58c40d1e13e10da5ULL,
+      0x6a75254809976355ULL,
+      0x3a50e4ef94244733ULL,
+      0x92f2f629dc4dd299ULL,
+      0xc12cc0e6ec7f180dULL,
+      0x92ac3b107ad0dc58ULL,
+      0x215ae3b96a0217b0ULL,
+      0x929f56510d0a1f9bULL,
+      0x1156008da8f3cb45ULL,
+      0xa6db1b3c6bb19bbdULL,
+      0x4149ec3bfd3c5b49ULL,
+      0x250322e6b654fa0aULL,
+      0x763dae322ae61471ULL,
+      0x492922c28bfecebfULL,
+      0xd366b5a877d19f49ULL,
+      0x80a41fab2a34f60cULL,
+      0xf8ec3a78b6f3e5c5ULL,
+      0xa451848f4bf0a47dULL,
+      0x6c3160125caf9481ULL,
+      0x58ba66cc3fd4406eULL,
+      0x9966ee599830777cULL,
+      0x8a7d47a723e1175aULL,
+      0xe218194c1d6e903cULL,
+      0xaf38ab08149738c0ULL,
+      0x795d4a0659c40e45ULL,
+      0xf75b82432b5ed03dULL,
+      0xdb7cb99e8d8ad11dULL,
+      0x414a4fe0c3979516ULL,
+      0xa67f54c162831901ULL,
+      0xda9eb18bb5f2f8dfULL,
+      0x79e96b07f5d39979ULL,
+      0x868c59c0735a5683ULL,
+      0x7b653ee34fda8a45ULL,
+      0x0db3f24ede346dadULL,
+      0x8e4312ebe668162bULL,
+      0xbf911032ef187e8eULL,
+      0x546aedc4d33af771ULL,
+      0xa5d62e87ed36ec6dULL,
+      0xa4c0ff71c9555f69ULL,
+      0x0d1ede98b76f6f44ULL,
+      0x39e63af80912a2c5ULL,
+      0xf51480731bd66eedULL,
+      0xe3c94b2d4ff77d3fULL,
+      0x1cc331ca5b7a7109ULL,
+      0xd65317497b0f4bbcULL,
+      0x61d546447225e1d4ULL,
+      0x5c3d5293f36d6ee7ULL,
+      0x35418f37f2fcc6ecULL,
+      0x307abb2fc43f1dc5ULL,
+      0x8a19b5390edb6c4dULL,
+      0x4444cd651deede01ULL,
+      0xde659b4a273a72c5ULL,
+      0x16fc6b56d7d906e4ULL,
+      0x82e79498c2b64857ULL,
+      0xc51e45325c610d78ULL,
+      0xc1bbeb6e7deaeaceULL,
+      0x877b602d02687845ULL,
+      0xfa0f1423187013b5ULL,
+      0x2a15826e44c86789ULL,
+      0xb62148927b4d7b09ULL,
+      0xc8e0e4d6483ffd5dULL,
+      0xe1aa95bd1698e013ULL,
+      0x631011421fc5eaf8ULL,
+      0x09287b41177a2494ULL,
+      0x39ed4f9686bc14c5ULL,
+      0xc0cc221e7c31fb0dULL,
+      0x54cf27de30ed6d6fULL,
+      0x0fc34fe7a29cb525ULL,
+      0x6e0303a9d6b496e8ULL,
+      0xe890c081d094b4d3ULL,
+      0x855ff886d789ae78ULL,
+      0x26b83c3b10272f34ULL,
+    };
+
+    static const float interleavermod_head[HEAD_LENGTH][2] = {
+      {-0.707106769f, -0.707106769f},
+      {0.707106769f, -0.707106769f},
+      {-0.707106769f, 0.707106769f},
+      {0.707106769f, -0.707106769f},
+      {0.707106769f, -0.707106769f},
+      {-0.707106769f, -0.707106769f},
+      {-0.707106769f, 0.707106769f},
+      {-0.707106769f, 0.707106769f},
+      {-0.707106769f, 0.707106769f},
+      {-0.707106769f, 0.707106769f},
+      {0.707106769f, 0.707106769f},
+      {-0.707106769f, -0.707106769f},
+      {0.707106769f, -0.707106769f},
+      {0.707106769f, 0.707106769f},
+      {0.707106769f, 0.707106769f},
+      {-0.707106769f, 0.707106769f},
+      {-0.707106769f, 0.707106769f},
+      {0.707106769f, -0.707106769f},
+      {-0.707106769f, 0.707106769f},
+      {-0.707106769f, 0.707106769f},
+      {-0.707106769f, 0.707106769f},
+      {0.707106769f, -0.707106769f},
+      {-0.707106769f, 0.707106769f},
+      {0.707106769f, 0.707106769f},
+      {-0.707106769f, -0.707106769f},
+      {0.707106769f, -0.707106769f},
+      {0.707106769f, -0.707106769f},
+      {0.707106769f, 0.707106769f},
+      {-0.707106769f, -0.707106769f},
+      {-0.707106769f, -0.707106769f},
+      {0.707106769f, 0.707106769f},
+      {0.707106769f, -0.707106769f},
+    };
+
+    static const uint64_t framemapper_hashes[] = {
+      0xdfff76d638c314ddULL,
+      0x4ed7e4185145a1e6ULL,
+      0x35eb586d6e62d5bfULL,
+      0x13fc86e470447171ULL,
+      0x3c227ece2722f1daULL,
+      0x55bee0f86c47a162ULL,
+    };
+
+    static const float framemapper_head[HEAD_LENGTH][2] = {
+      {1.0f, 0.0f},
+      {-0.316227764f, -0.948683262f},
+      {1.0f, 0.0f},
+      {-0.948683262f, -0.948683262f},
+      {-0.316227764f, -0.948683262f},
+      {0.316227764f, -0.948683262f},
+      {-1.0f, 0.0f},
+      {0.316227764f, 0.948683262f},
+      {1.0f, 0.0f},
+      {-0.316227764f, 0.948683262f},
+      {0.948683321f, 0.948683321f},
+      {-0.316227764f, 0.948683262f},
+      {-1.0f, 0.0f},
+      {-1.0f, 0.0f},
+      {1.0f, 0.0f},
+      {1.0f, 0.0f},
+      {1.0f, 0.0f},
+      {0.316227764f, -0.948683262f},
+      {0.316227764f, -0.948683262f},
+      {1.0f, 0.0f},
+      {-0.316227764f, -0.948683262f},
+      {0.948683262f, 0.948683262f},
+      {-0.316227764f, -0.948683262f},
+      {0.316227764f, -0.316227764f},
+      {-0.316227764f, -0.948683262f},
+      {-1.0f, 0.0f},
+      {0.316227764f, 0.948683262f},
+      {1.0f, 0.0f},
+      {-1.0f, 0.0f},
+      {-1.0f, 0.0f},
+      {0.948683262f, -0.316227764f},
+      {1.0f, 0.0f},
+    };
+
+    static const double pilotgen_energy[] = {
+      0.95747353764731458,
+      0.99789482759207304,
+      0.95826487088037227,
+      0.99235444536258643,
+      0.96515221705510568,
+      0.957663193757883,
+    };
+
+    static const float pilotgen_samples[][PILOT_SAMPLES][2] = {
+      {
+        {1.36593103f, 0.1202773f},
+        {0.839448869f, 0.216200292f},
+        {-0.431146532f, 1.13261259f},
+        {1.755862f, 0.683957517f},
+        {0.385141701f, 0.646155715f},
+        {-0.511300266f, -1.06874287f},
+        {-0.0632974431f, 0.518680632f},
+        {0.223573312f, -0.642947674f},
+        {0.142902449f, -0.207136527f},
+        {0.22759296f, -0.53128022f},
+        {0.302224398f, 0.336707056f},
+        {0.339147896f, -0.0646922439f},
+        {-0.377061039f, -0.561060905f},
+        {0.41233173f, 0.811638534f},
+        {0.175237924f, -0.820851743f},
+        {-1.51022804f, -0.126551718f},
+        {0.000175553549f, -0.350200146f},
+        {-0.96072799f, 0.611579537f},
+        {0.457153738f, 0.467216074f},
+        {1.24016035f, -0.800620735f},
+        {-1.17735267f, -0.448832273f},
+        {1.0677377f, -0.947797179f},
+        {-0.611629367f, 0.958019793f},
+        {0.483531535f, 0.0804699063f},
+        {0.0864619687f, -0.23503533f},
+        {0.420434684f, 0.482702166f},
+        {0.497930706f, 0.325609416f},
+        {-1.23420048f, -1.19675982f},
+        {0.481183261f, -0.96301198f},
+        {0.0077498015f, -0.714554429f},
+        {0.0728186816f, 0.0340246819f},
+        {0.0674768761f, -0.826770067f},
+      },
+      {
+        {-1.05171621f, 0.148568705f},
+        {0.634793937f, 0.412046283f},
+        {1.15410292f, -0.0102527542f},
+        {0.570878327f, 0.214263961f},
+        {-1.09544802f, -0.201198444f},
+        {-1.45180631f, -1.6299417f},
+        {-0.425248682f, 0.161871746f},
+        {0.437813044f, 0.115023896f},
+        {-0.0348552093f, -0.591636896f},
+        {-0.851685762f, -0.320010155f},
+        {0.89304173f, 1.11900926f},
+        {0.206948146f, -1.2195574f},
+        {1.07885635f, -0.794908881f},
+        {-0.92220819f, -0.225651979f},
+        {-0.0376718752f, 0.398527771f},
+        {-0.0126208905f, -0.21383284f},
+        {-0.0908652917f, -0.698202193f},
+        {0.51862818f, -0.361311257f},
+        {1.15618896f, -0.91840595f},
+        {-0.113117196f, -0.690260231f},
+        {0.997375011f, -1.08346784f},
+        {-1.85062623f, 0.247976527f},
+        {-0.0466736518f, 0.0594079494f},
+        {0.0628323033f, -0.214060992f},
+        {-0.2391112f, -0.294941545f},
+        {0.837798715f, 0.00875616167f},
+        {1.23820221f, 0.163192466f},
+        {-1.34502387f, 0.506338f},
+        {0.971885979f, 1.36041903f},
+        {-0.674595535f, -0.0674406588f},
+        {-0.130274713f, -0.3415007f},
+        {-0.873262703f, -1.13738704f},
+      },
+      {
+        {0.452637345f, 0.974693954f},
+        {0.239842668f, -0.69181031f},
+        {-1.19948125f, 0.429716587f},
+        {0.449133098f, -0.380690217f},
+        {-0.396881938f, 0.380082458f},
+        {-1.15197122f, 0.194870263f},
+        {-0.454892278f, 1.35034859f},
+        {0.313726127f, 0.249348f},
+        {-0.705980241f, 2.49259114f},
+        {0.233809829f, 0.613862753f},
+        {1.06910503f, 0.540174663f},
+        {0.170935377f, -0.506771266f},
+        {0.000111751535f, 0.574168503f},
+        {0.0205394514f, 1.28646922f},
+        {0.133262649f, -0.265659362f},
+        {0.0282865763f, -2.06799459f},
+        {0.10368026f, 1.29783607f},
+        {-0.700572312f, 0.12717931f},
+        {-0.674270928f, 0.223433599f},
+        {0.19704026f, 0.584484696f},
+        {-0.262669832f, 0.214364037f},
+        {0.0534011684f, 0.0994839147f},
+        {-0.7421031f, 0.274546653f},
+        {-0.584598482f, 0.681108475f},
+        {-0.651405752f, 0.642977834f},
+        {-1.12394774f, 0.608666301f},
+        {0.724801064f, 0.817855239f},
+        {0.450029492f, -0.595186591f},
+        {-0.803157389f, 1.0028671f},
+        {-0.0111948345f, 1.1715554f},
+        {0.743071437f, -1.01930392f},
+        {-0.771539092f, -1.74600554f},
+      },
+      {
+        {0.309993416f, -0.502782166f},
+        {-0.246266961f, 0.752075195f},
+        {-0.0355094709f, -0.422962338f},
+        {0.0664539337f, 0.0315927379f},
+        {-0.125275955f, 0.0185688324f},
+        {-0.321205109f, 0.206105053f},
+        {0.458592802f, -0.139618292f},
+        {0.158092752f, 0.235738888f},
+        {-0.0144278556f, 0.244218811f},
+        {-0.386472583f, 0.850886643f},
+        {-0.123192377f, 0.66728425f},
+        {0.57341975f, -0.973156571f},
+        {-0.63212049f, -0.581919193f},
+        {-0.32767877f, -1.16758537f},
+        {-0.583100379f, -0.520461857f},
+        {0.683320165f, -0.412186742f},
+        {0.466282755f, 0.120263681f},
+        {-0.803771496f, 0.504295826f},
+        {-1.36819673f, 0.0594921559f},
+        {0.536982834f, -0.379824817f},
+        {-2.08094716f, -0.0843134075f},
+        {-0.164196149f, 0.0382270105f},
+        {0.357841343f, -0.423855543f},
+        {-0.405763179f, 0.0263006222f},
+        {-0.301032811f, 0.743263721f},
+        {1.24745357f, 0.204571858f},
+        {0.215415075f, -0.343175769f},
+        {-0.104526013f, -0.125030681f},
+        {1.79429591f, 0.0250582322f},
+        {0.167570069f, -0.496919006f},
+        {-0.790318549f, 0.128951162f},
+        {0.408792943f, -0.392698258f},
+      },
+      {
+        {0.371665537f, -0.357589096f},
+        {0.801965177f, 0.361154586f},
+        {0.137835026f, -0.00291887298f},
+        {-0.180169538f, -0.599394977f},
+        {-0.14791058f, -0.159215704f},
+        {-0.745757639f, 0.359882444f},
+        {-0.615708768f, -0.0606437065f},
+        {0.0311727412f, -0.487306356f},
+        {0.540460825f, -0.408383191f},
+        {0.231544957f, 0.772955656f},
+        {-0.314105958f, 0.451194495f},
+        {-0.25658524f, 0.358647108f},
+        {0.0261286777f, -0.0336868837f},
+        {1.09813952f, 0.133555695f},
+        {0.000892655982f, 0.615588784f},
+        {0.336675048f, -0.79033643f},
+        {0.403614342f, -0.637312949f},
+        {0.608329058f, 0.094716832f},
+        {-0.86844027f, -0.73242408f},
+        {0.0663452446f, -0.472362965f},
+        {-0.0705982f, -0.939362288f},
+        {-0.354308426f, 0.833607554f},
+        {0.25656718f, 0.834613323f},
+        {0.0269384217f, -0.0703992024f},
+        {0.652210295f, -1.71613801f},
+        {-0.602367103f, 0.402988255f},
+        {0.574490726f, 0.521849513f},
+        {0.958698869f, 0.673402369f},
+        {-0.468464613f, -0.0297454167f},
+        {0.552234232f, -0.948290288f},
+        {-0.134195358f, 0.0519528389f},
+        {1.35673463f, -0.247206777f},
+      },
+      {
+        {-0.289331168f, 0.0332100466f},
+        {1.41061699f, -0.290410221f},
+        {-2.149297f, 0.589459002f},
+        {-0.147432432f, 0.565847039f},
+        {0.525585771f, -0.345455736f},
+        {0.686080277f, -0.524387062f},
+        {1.73965085f, 1.26304328f},
+        {1.27149105f, -1.05857503f},
+        {1.15033269f, 0.527889073f},
+        {0.0705727413f, 0.13254115f},
+        {2.23357129f, -0.179965615f},
+        {0.0942153111f, -0.568181634f},
+        {1.126109f, -0.207578465f},
+        {0.196021348f, -0.755801558f},
+        {-0.709485471f, 2.26803255f},
+        {1.25915456f, -0.655548215f},
+        {-0.495777994f, -0.152699247f},
+        {1.02145457f, 0.10812857f},
+        {-1.00988615f, 0.0830275342f},
+        {0.619181454f, 1.2942915f},
+        {-0.492490083f, -0.459647506f},
+        {-0.0192841589f, -0.0749643594f},
+        {0.164298445f, -0.170268655f},
+        {-0.118826419f, -1.44085646f},
+        {0.801998734f, -0.460816443f},
+        {0.446316838f, 0.803431392f},
+        {0.802385032f, -1.5176301f},
+        {0.575587034f, -1.54465437f},
+        {-0.821597338f, -0.296485007f},
+        {0.0471651331f, -0.148142025f},
+        {-0.209787264f, -1.03619599f},
+        {-0.653986037f, 0.539104402f},
+      },
+    };
+
+    #define N_ELEMENTS(x) (sizeof(x) / sizeof(x[0]))
+
+    static uint32_t lcg_state;
+
+    static inline uint32_t
+    lcg_next(void)
+    {
+      lcg_state = lcg_state * 1664525 + 1013904223;
+      return lcg_state >> 8;
+    }
+
+    static uint64_t
+    fnv1a(const void *data, size_t length)
+    {
+      const unsigned char *p = (const unsigned char *)data;
+      uint64_t hash = 0xcbf29ce484222325ULL;
+
+      for (size_t i = 0; i < length; i++) {
+        hash ^= p[i];
+        hash *= 0x100000001b3ULL;
+      }
+      return hash;
+    }
+
+    static bool
+    recording(void)
+    {
+      const char *env = getenv("DVBT2LL_GOLDEN_RECORD");
+
+      return env != NULL && env[0] != '\0' && env[0] != '0';
+    }
+
+    static void
+    print_hashes(const char *name, const std::vector<uint64_t> &hashes)
+    {
+      printf("    static const uint64_t %s[] = {\n", name);
+      for (size_t i = 0; i < hashes.size(); i++) {
+        printf("      0x%016llxULL,\n", (unsigned long long)hashes[i]);
+      }
+      printf("    };\n\n");
+    }
+
+    /* Prints a float literal that reads back to the same value */
+    static void
+    print_float(float value)
+    {
+      char text[32];
+
+      snprintf(text, sizeof(text), "%.9g", value);
+      if (strpbrk(text, ".en") == NULL) {
+        strcat(text, ".0");
+      }
+      printf("%sf", text);
+    }
+
+    static void
+    print_cell(const char *indent, gr_complex cell)
+    {
+      printf("%s{", indent);
+      print_float(cell.real());
+      printf(", ");
+      print_float(cell.imag());
+      printf("},\n");
+    }
+
+    static void
+    print_cells(const char *name, const gr_complex *cells)
+    {
+      printf("    static const float %s[HEAD_LENGTH][2] = {\n", name);
+      for (int i = 0; i < HEAD_LENGTH; i++) {
+        print_cell("      ", cells[i]);
+      }
+      printf("    };\n\n");
+    }
+
+    /*
+     * Runs a block outside a flowgraph. It gets a detail so
+     * consume_each() and the item counters work, and general_work()
+     * is called until out is full. out2 is the second output of a
+     * block that has two.
+     */
+    template <class I, class O>
+    static void
+    run_block(gr::block_sptr blk, const std::vector<I> &in, std::vector<O> &out, std::vector<O> *out2 = NULL)
+    {
+      int outputs = out2 == NULL ? 1 : 2;
+      gr::block_detail_sptr detail = gr::make_block_detail(1, outputs);
+      gr::buffer_sptr in_buf = gr::make_buffer(4096, sizeof(I), blk);
+      gr_vector_int ninput_items(1);
+      gr_vector_const_void_star input_items(1);
+      gr_vector_void_star output_items(outputs);
+      int produced = 0;
+      int consumed, n;
+
+      detail->set_input(0, gr::buffer_add_reader(in_buf, 0, blk));
+      for (int i = 0; i < outputs; i++) {
+        detail->set_output(i, gr::make_buffer(4096, sizeof(O), blk));
+      }
+      blk->set_detail(detail);
+      while (produced < (int)out.size()) {
+        consumed = blk->nitems_read(0);
+        CPPUNIT_ASSERT(consumed <= (int)in.size());
+        ninput_items[0] = in.size() - consumed;
+        input_items[0] = &in[consumed];
+        output_items[0] = &out[produced];
+        if (out2 != NULL) {
+          output_items[1] = &(*out2)[produced];
+        }
+        n = blk->general_work(out.size() - produced, ninput_items, input_items, output_items);
+        CPPUNIT_ASSERT(n > 0);
+        blk->detail()->produce_each(n);
+        produced += n;
+      }
+    }
+
+    static int
+    required_input(gr::block_sptr blk)
+    {
+      gr_vector_int ninput_items_required(1, 0);
+
+      blk->forecast(blk->output_multiple(), ninput_items_required);
+      return ninput_items_required[0] * GOLDEN_FRAMES;
+    }
+
+    static void
+    fill_cells(std::vector<gr_complex> &cells)
+    {
+      static const float levels[4] = {-3.0f, -1.0f, 1.0f, 3.0f};
+      const float normalization = 1.0f / std::sqrt(10.0f);
+
+      for (size_t i = 0; i < cells.size(); i++) {
+        cells[i] = gr_complex(levels[lcg_next() & 0x3] * normalization, levels[lcg_next() & 0x3] * normalization);
+      }
+    }
+
+    static void
+    check_cells(const float (*head)[2], const gr_complex *cells)
+    {
+      for (int i = 0; i < HEAD_LENGTH; i++) {
+        CPPUNIT_ASSERT_EQUAL(head[i][0], cells[i].real());
+        CPPUNIT_ASSERT_EQUAL(head[i][1], cells[i].imag());
+      }
+    }
+
+    void
+    qa_golden_vectors::t1_bbheaderbch()
+    {
+      std::vector<uint64_t> hashes;
+
+      for (size_t c = 0; c < N_ELEMENTS(bbheader_configs); c++) {
+        const bbheader_config &cfg = bbheader_configs[c];
+        bbheaderbch_bb::sptr blk = bbheaderbch_bb::make(cfg.framesize, cfg.rate, cfg.mode, cfg.inband, cfg.fecblocks, cfg.tsrate);
+        std::vector<unsigned char> in(required_input(blk) + 188);
+        std::vector<unsigned char> out(blk->output_multiple() * GOLDEN_FRAMES);
+
+        lcg_state = c;
+        for (size_t i = 0; i < in.size(); i++) {
+          in[i] = (i % 188) == 0 ? 0x47 : lcg_next() & 0xff;
+        }
+        run_block(blk, in, out);
+        hashes.push_back(fnv1a(&out[0], out.size()));
+        if (c == 0 && recording()) {
+          printf("    static const unsigned char bbheader_head[HEAD_LENGTH] = {\n     ");
+          for (int i = 0; i < HEAD_LENGTH; i++) {
+            printf(" %d,", out[i]);
+          }
+          printf("\n    };\n\n");
+        }
+        else if (c == 0) {
+          for (int i = 0; i < HEAD_LENGTH; i++) {
+            CPPUNIT_ASSERT_EQUAL((int)bbheader_head[i], (int)out[i]);
+          }
+        }
+      }
+      if (recording()) {
+        print_hashes("bbheader_hashes", hashes);
+        return;
+      }
+      CPPUNIT_ASSERT_EQUAL(N_ELEMENTS(bbheader_hashes), hashes.size());
+      for (size_t c = 0; c < hashes.size(); c++) {
+        CPPUNIT_ASSERT_EQUAL(bbheader_hashes[c], hashes[c]);
+      }
+    }
+
+    void
+    qa_golden_vectors::t2_interleavermod()
+    {
+      std::vector<uint64_t> hashes;
+
+      for (size_t c = 0; c < N_ELEMENTS(interleavermod_configs); c++) {
+        for (int m = 0; m < INTERLEAVERMOD_MODES; m++) {
+          const interleavermod_config &cfg = interleavermod_configs[c];
+          dvbt2_constellation_t constellation = (dvbt2_constellation_t)(m / 2);
+          dvbt2_rotation_t rotation = (m & 0x1) ? ROTATION_ON : ROTATION_OFF;
+          interleavermod_bc::sptr blk = interleavermod_bc::make(cfg.framesize, cfg.rate, constellation, rotation);
+          std::vector<unsigned char> in(required_input(blk));
+          std::vector<gr_complex> out(blk->output_multiple() * GOLDEN_FRAMES);
+
+          lcg_state = c * INTERLEAVERMOD_MODES + m;
+          for (size_t i = 0; i < in.size(); i++) {
+            in[i] = lcg_next() & 0x1;
+          }
+          run_block(blk, in, out);
+          hashes.push_back(fnv1a(&out[0], out.size() * sizeof(gr_complex)));
+          if (c == 0 && m == 0) {
+            if (recording()) {
+              print_cells("interleavermod_head", &out[0]);
+            }
+            else {
+              check_cells(interleavermod_head, &out[0]);
+            }
+          }
+        }
+      }
+      if (recording()) {
+        print_hashes("interleavermod_hashes", hashes);
+        return;
+      }
+      CPPUNIT_ASSERT_EQUAL(N_ELEMENTS(interleavermod_hashes), hashes.size());
+      for (size_t c = 0; c < hashes.size(); c++) {
+        CPPUNIT_ASSERT_EQUAL(interleavermod_hashes[c], hashes[c]);
+      }
+    }
+
+    /* Streaming, frames per call and the pipeline don't change the frame mapper output */
+    struct framemapper_mode
+    {
+      int streamsymbols;
+      int maxframes;
+      dvbt2_pipeline_t pipeline;
+    };
+
+    static const framemapper_mode framemapper_modes[] = {
+      {0, 0, PIPELINE_OFF},
+      {0, 2, PIPELINE_OFF},
+      {2, 1, PIPELINE_OFF},
+      {0, 1, PIPELINE_ON},
+      {0, 2, PIPELINE_ON},
+      {3, 1, PIPELINE_ON},
+    };
+
+    /*
+     * Changes the configuration of blk and runs it for two
+     * super-frames, so the change takes effect at the second. stop()
+     * and start() wait for the new tables.
+     */
+    static uint64_t
+    change_config(framemapperfint_cc::sptr blk, const frame_config &cfg, dvbt2_rotation_t rotation)
+    {
+      std::vector<gr_complex> in((required_input(blk) / GOLDEN_FRAMES) * 2 * cfg.t2frames);
+      std::vector<gr_complex> out(blk->output_multiple() * 2 * cfg.t2frames);
+
+      blk->set_config(cfg.constellation, rotation, cfg.fecblocks, cfg.tiblocks, cfg.l1constellation, cfg.t2frames);
+      blk->stop();
+      blk->start();
+      fill_cells(in);
+      run_block(blk, in, out);
+      return fnv1a(&out[0], out.size() * sizeof(gr_complex));
+    }
+
+    void
+    qa_golden_vectors::t3_framemapperfint()
+    {
+      std::vector<uint64_t> hashes;
+
+      for (size_t c = 0; c < N_ELEMENTS(frame_configs); c++) {
+        const frame_config &cfg = frame_configs[c];
+        framemapperfint_cc::sptr blk = framemapperfint_cc::make(cfg.framesize, cfg.rate, cfg.constellation, ROTATION_OFF, cfg.fecblocks, cfg.tiblocks, cfg.carriermode, cfg.fftsize, cfg.guardinterval, cfg.l1constellation, cfg.pilotpattern, cfg.t2frames, cfg.numdatasyms, cfg.paprmode, VERSION_131, cfg.preamble, INPUTMODE_NORMAL, RESERVED_OFF, cfg.l1scrambled, INBAND_OFF);
+        std::vector<gr_complex> in(required_input(blk));
+        std::vector<gr_complex> out(blk->output_multiple() * GOLDEN_FRAMES);
+
+        lcg_state = c;
+        fill_cells(in);
+        blk->start();
+        run_block(blk, in, out);
+        blk->stop();
+        hashes.push_back(fnv1a(&out[0], out.size() * sizeof(gr_complex)));
+        for (size_t m = 0; m < N_ELEMENTS(framemapper_modes); m++) {
+          const framemapper_mode &mode = framemapper_modes[m];
+          framemapperfint_cc::sptr variant = framemapperfint_cc::make(cfg.framesize, cfg.rate, cfg.constellation, ROTATION_OFF, cfg.fecblocks, cfg.tiblocks, cfg.carriermode, cfg.fftsize, cfg.guardinterval, cfg.l1constellation, cfg.pilotpattern, cfg.t2frames, cfg.numdatasyms, cfg.paprmode, VERSION_131, cfg.preamble, INPUTMODE_NORMAL, RESERVED_OFF, cfg.l1scrambled, INBAND_OFF, mode.streamsymbols, mode.maxframes, mode.pipeline);
+          std::vector<gr_complex> variant_out(out.size());
+
+          variant->start();
+          run_block(variant, in, variant_out);
+          variant->stop();
+          CPPUNIT_ASSERT_EQUAL(hashes.back(), fnv1a(&variant_out[0], variant_out.size() * sizeof(gr_complex)));
+        }
+        /* a change of rotation and back leaves the output as it was */
+        {
+          framemapperfint_cc::sptr changed = framemapperfint_cc::make(cfg.framesize, cfg.rate, cfg.constellation, ROTATION_OFF, cfg.fecblocks, cfg.tiblocks, cfg.carriermode, cfg.fftsize, cfg.guardinterval, cfg.l1constellation, cfg.pilotpattern, cfg.t2frames, cfg.numdatasyms, cfg.paprmode, VERSION_131, cfg.preamble, INPUTMODE_NORMAL, RESERVED_OFF, cfg.l1scrambled, INBAND_OFF);
+          std::vector<gr_complex> changed_out(out.size());
+          uint64_t rotated;
+
+          changed->start();
+          lcg_state = c;
+          rotated = change_config(changed, cfg, ROTATION_ON);
+          lcg_state = c;
+          CPPUNIT_ASSERT(rotated != change_config(changed, cfg, ROTATION_OFF));
+          run_block(changed, in, changed_out);
+          changed->stop();
+          CPPUNIT_ASSERT_EQUAL(hashes.back(), fnv1a(&changed_out[0], changed_out.size() * sizeof(gr_complex)));
+        }
+        if (c == 0) {
+          if (recording()) {
+            print_cells("framemapper_head", &out[0]);
+          }
+          else {
+            check_cells(framemapper_head, &out[0]);
+          }
+        }
+      }
+      if (recording()) {
+        print_hashes("framemapper_hashes", hashes);
+        return;
+      }
+      CPPUNIT_ASSERT_EQUAL(N_ELEMENTS(framemapper_hashes), hashes.size());
+      for (size_t c = 0; c < hashes.size(); c++) {
+        CPPUNIT_ASSERT_EQUAL(framemapper_hashes[c], hashes[c]);
+      }
+    }
+
+    /*
+     * The IFFT is not bit-exact across FFT libraries and SIMD paths,
+     * so the pilot generator is checked on the frame energy and on
+     * PILOT_SAMPLES outputs spread over the frames.
+     */
+    /* Streaming and frames per call don't change the pilot generator output */
+    static const int pilotgen_modes[][2] = {
+      {0, 0},
+      {0, 2},
+      {1, 1},
+      {4, 1},
+    };
+
+    void
+    qa_golden_vectors::t4_pilotgenp1insert()
+    {
+      std::vector<double> energies;
+      std::vector<std::vector<gr_complex> > samples;
+
+      for (size_t c = 0; c < N_ELEMENTS(frame_configs); c++) {
+        const frame_config &cfg = frame_configs[c];
+        dvbt2_misogroup_t misogroup = cfg.preamble == PREAMBLE_T2_MISO ? MISO_TX2 : MISO_TX1;
+        pilotgenp1insert_cc::sptr blk = pilotgenp1insert_cc::make(cfg.carriermode, cfg.fftsize, cfg.pilotpattern, cfg.guardinterval, cfg.numdatasyms, cfg.paprmode, VERSION_131, cfg.preamble, misogroup, cfg.equalization, cfg.bandwidth, cfg.vlength);
+        std::vector<gr_complex> in(required_input(blk));
+        std::vector<gr_complex> out(blk->output_multiple() * GOLDEN_FRAMES);
+        std::vector<gr_complex> sample(PILOT_SAMPLES);
+        size_t stride = out.size() / PILOT_SAMPLES;
+        double energy = 0.0;
+
+        lcg_state = c;
+        fill_cells(in);
+        run_block(blk, in, out);
+        for (size_t i = 0; i < out.size(); i++) {
+          energy += std::norm(out[i]);
+        }
+        for (int i = 0; i < PILOT_SAMPLES; i++) {
+          sample[i] = out[(i * stride) + (stride / 2)];
+        }
+        energies.push_back(energy / out.size());
+        samples.push_back(sample);
+        for (size_t m = 0; m < N_ELEMENTS(pilotgen_modes); m++) {
+          pilotgenp1insert_cc::sptr variant = pilotgenp1insert_cc::make(cfg.carriermode, cfg.fftsize, cfg.pilotpattern, cfg.guardinterval, cfg.numdatasyms, cfg.paprmode, VERSION_131, cfg.preamble, misogroup, cfg.equalization, cfg.bandwidth, cfg.vlength, pilotgen_modes[m][0], pilotgen_modes[m][1]);
+          std::vector<gr_complex> variant_out(out.size());
+
+          run_block(variant, in, variant_out);
+          CPPUNIT_ASSERT_EQUAL(fnv1a(&out[0], out.size() * sizeof(gr_complex)), fnv1a(&variant_out[0], variant_out.size() * sizeof(gr_complex)));
+        }
+      }
+      if (recording()) {
+        printf("    static const double pilotgen_energy[] = {\n");
+        for (size_t c = 0; c < energies.size(); c++) {
+          printf("      %.17g,\n", energies[c]);
+        }
+        printf("    };\n\n");
+        printf("    static const float pilotgen_samples[][PILOT_SAMPLES][2] = {\n");
+        for (size_t c = 0; c < samples.size(); c++) {
+          printf("      {\n");
+          for (int i = 0; i < PILOT_SAMPLES; i++) {
+            print_cell("        ", samples[c][i]);
+          }
+          printf("      },\n");
+        }
+        printf("    };\n\n");
+        return;
+      }
+      CPPUNIT_ASSERT_EQUAL(N_ELEMENTS(pilotgen_energy), energies.size());
+      CPPUNIT_ASSERT_EQUAL(N_ELEMENTS(pilotgen_samples), samples.size());
+      for (size_t c = 0; c < energies.size(); c++) {
+        double rms = std::sqrt(pilotgen_energy[c]);
+
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(pilotgen_energy[c], energies[c], pilotgen_energy[c] * PILOT_TOLERANCE);
+        for (int i = 0; i < PILOT_SAMPLES; i++) {
+          CPPUNIT_ASSERT_DOUBLES_EQUAL(pilotgen_samples[c][i][0], samples[c][i].real(), rms * PILOT_TOLERANCE);
+          CPPUNIT_ASSERT_DOUBLES_EQUAL(pilotgen_samples[c][i][1], samples[c][i].imag(), rms * PILOT_TOLERANCE);
+        }
+      }
+    }
+
+    /*
+     * The LDPC encoder of the fused transmitter isn't reachable from
+     * here, so its stage threads are checked against the same frames
+     * computed in the scheduler thread instead.
+     */
+    void
+    qa_golden_vectors::t5_transmitter()
+    {
+      static const int threads[TRANSMITTER_THREADS] = {0, 2, 4};
+
+      for (size_t c = 0; c < N_ELEMENTS(frame_configs); c++) {
+        const frame_config &cfg = frame_configs[c];
+        dvbt2_misogroup_t misogroup = cfg.preamble == PREAMBLE_T2_MISO ? MISO_TX2 : MISO_TX1;
+        std::vector<unsigned char> in;
+        std::vector<gr_complex> reference;
+        double energy = 0.0;
+
+        for (int t = 0; t < TRANSMITTER_THREADS; t++) {
+          transmitter_bc::sptr blk = transmitter_bc::make(cfg.framesize, cfg.rate, cfg.constellation, ROTATION_OFF, cfg.fecblocks, cfg.tiblocks, cfg.carriermode, cfg.fftsize, cfg.guardinterval, cfg.l1constellation, cfg.pilotpattern, cfg.t2frames, cfg.numdatasyms, cfg.paprmode, VERSION_131, cfg.preamble, INPUTMODE_NORMAL, RESERVED_OFF, cfg.l1scrambled, INBAND_OFF, 0, misogroup, cfg.equalization, cfg.bandwidth, cfg.vlength, threads[t]);
+          std::vector<gr_complex> out(blk->output_multiple() * GOLDEN_FRAMES);
+
+          if (t == 0) {
+            in.resize(required_input(blk));
+            lcg_state = c;
+            for (size_t i = 0; i < in.size(); i++) {
+              in[i] = (i % 188) == 0 ? 0x47 : lcg_next() & 0xff;
+            }
+          }
+          blk->start();
+          run_block(blk, in, out);
+          blk->stop();
+          if (t == 0) {
+            reference = out;
+            for (size_t i = 0; i < out.size(); i++) {
+              energy += std::norm(out[i]);
+            }
+            CPPUNIT_ASSERT(energy > 0.0);
+            continue;
+          }
+          double rms = std::sqrt(energy / out.size());
+          for (size_t i = 0; i < out.size(); i++) {
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(reference[i].real(), out[i].real(), rms * PILOT_TOLERANCE);
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(reference[i].imag(), out[i].imag(), rms * PILOT_TOLERANCE);
+          }
+        }
+      }
+    }
+
+    /*
+     * The libdvbt2ll-core classes on their own, against the reference
+     * vectors of the blocks that wrap them. Not run when recording.
+     */
+    void
+    qa_golden_vectors::t6_core()
+    {
+      if (recording()) {
+        return;
+      }
+      for (size_t c = 0; c < N_ELEMENTS(bbheader_configs); c++) {
+        const bbheader_config &cfg = bbheader_configs[c];
+        bbframe_encoder::sptr encoder = bbframe_encoder::make(cfg.framesize, cfg.rate, cfg.mode, cfg.inband, cfg.fecblocks, cfg.tsrate);
+        std::vector<unsigned char> in(encoder->input_items(GOLDEN_FRAMES) + 188);
+        std::vector<unsigned char> out(encoder->bch_bits() * GOLDEN_FRAMES);
+        const unsigned char *ts = &in[0];
+
+        lcg_state = c;
+        for (size_t i = 0; i < in.size(); i++) {
+          in[i] = (i % 188) == 0 ? 0x47 : lcg_next() & 0xff;
+        }
+        for (int b = 0; b < GOLDEN_FRAMES; b++) {
+          ts += encoder->encode_frame(ts, &out[b * encoder->bch_bits()]);
+        }
+        CPPUNIT_ASSERT_EQUAL(bbheader_hashes[c], fnv1a(&out[0], out.size()));
+        CPPUNIT_ASSERT_EQUAL((uint64_t)0, encoder->sync_errors());
+      }
+      for (size_t c = 0; c < N_ELEMENTS(interleavermod_configs); c++) {
+        for (int m = 0; m < INTERLEAVERMOD_MODES; m++) {
+          const interleavermod_config &cfg = interleavermod_configs[c];
+          dvbt2_constellation_t constellation = (dvbt2_constellation_t)(m / 2);
+          dvbt2_rotation_t rotation = (m & 0x1) ? ROTATION_ON : ROTATION_OFF;
+          cell_modulator::sptr modulator = cell_modulator::make(cfg.framesize, cfg.rate, constellation, rotation);
+          std::vector<unsigned char> in(modulator->input_items() * GOLDEN_FRAMES);
+          std::vector<gr_complex> out(modulator->output_items() * GOLDEN_FRAMES);
+
+          lcg_state = c * INTERLEAVERMOD_MODES + m;
+          for (size_t i = 0; i < in.size(); i++) {
+            in[i] = lcg_next() & 0x1;
+          }
+          CPPUNIT_ASSERT_EQUAL((int)in.size(), modulator->process(&in[0], &out[0], GOLDEN_FRAMES));
+          CPPUNIT_ASSERT_EQUAL(interleavermod_hashes[c * INTERLEAVERMOD_MODES + m], fnv1a(&out[0], out.size() * sizeof(gr_complex)));
+        }
+      }
+      for (size_t c = 0; c < N_ELEMENTS(frame_configs); c++) {
+        const frame_config &cfg = frame_configs[c];
+        dvbt2_misogroup_t misogroup = cfg.preamble == PREAMBLE_T2_MISO ? MISO_TX2 : MISO_TX1;
+        frame_mapper::sptr mapper = frame_mapper::make(cfg.framesize, cfg.rate, cfg.constellation, ROTATION_OFF, cfg.fecblocks, cfg.tiblocks, cfg.carriermode, cfg.fftsize, cfg.guardinterval, cfg.l1constellation, cfg.pilotpattern, cfg.t2frames, cfg.numdatasyms, cfg.paprmode, VERSION_131, cfg.preamble, INPUTMODE_NORMAL, RESERVED_OFF, cfg.l1scrambled, INBAND_OFF);
+        ofdm_modulator::sptr ofdm = ofdm_modulator::make(cfg.carriermode, cfg.fftsize, cfg.pilotpattern, cfg.guardinterval, cfg.numdatasyms, cfg.paprmode, VERSION_131, cfg.preamble, misogroup, cfg.equalization, cfg.bandwidth, cfg.vlength);
+        std::vector<gr_complex> in(mapper->input_items() * GOLDEN_FRAMES);
+        std::vector<gr_complex> mapped(mapper->output_items() * GOLDEN_FRAMES);
+        std::vector<gr_complex> cells(ofdm->input_items() * GOLDEN_FRAMES);
+        std::vector<gr_complex> out(ofdm->output_items() * GOLDEN_FRAMES);
+        double energy = 0.0;
+
+        CPPUNIT_ASSERT(mapper->fits());
+        lcg_state = c;
+        fill_cells(in);
+        CPPUNIT_ASSERT_EQUAL((int)in.size(), mapper->process(&in[0], &mapped[0], GOLDEN_FRAMES));
+        CPPUNIT_ASSERT_EQUAL(framemapper_hashes[c], fnv1a(&mapped[0], mapped.size() * sizeof(gr_complex)));
+        lcg_state = c;
+        fill_cells(cells);
+        CPPUNIT_ASSERT_EQUAL((int)cells.size(), ofdm->process(&cells[0], &out[0], GOLDEN_FRAMES));
+        for (size_t i = 0; i < out.size(); i++) {
+          energy += std::norm(out[i]);
+        }
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(pilotgen_energy[c], energy / out.size(), pilotgen_energy[c] * PILOT_TOLERANCE);
+      }
+    }
+
+    static loopplayout_c::sptr
+    make_playout(const char *tsfile, const char *cachefile, int tsrate)
+    {
+      return loopplayout_c::make(tsfile, cachefile, FECFRAME_SHORT, C3_5, MOD_QPSK, ROTATION_OFF, 1, 1, CARRIERS_NORMAL, FFTSIZE_1K, GI_1_8, L1_MOD_BPSK, PILOT_PP1, 1, 6, PAPR_OFF, VERSION_131, PREAMBLE_T2_SISO, INPUTMODE_NORMAL, RESERVED_OFF, L1_SCRAMBLED_OFF, INBAND_OFF, tsrate, MISO_TX1, EQUALIZATION_OFF, BANDWIDTH_8_0_MHZ, 1024, PLAYOUT_FRAMES);
+    }
+
+    static void
+    run_playout(loopplayout_c::sptr blk, std::vector<gr_complex> &out)
+    {
+      gr_vector_const_void_star input_items;
+      gr_vector_void_star output_items(1);
+      int produced = 0;
+      int n;
+
+      /* odd lengths, so the wrap falls inside a call */
+      while (produced < (int)out.size()) {
+        n = std::min((int)out.size() - produced, 1000 + (produced % 7919));
+        output_items[0] = &out[produced];
+        CPPUNIT_ASSERT_EQUAL(n, blk->work(n, input_items, output_items));
+        produced += n;
+      }
+    }
+
+    static ino_t
+    file_inode(const char *name)
+    {
+      struct stat st;
+
+      CPPUNIT_ASSERT_EQUAL(0, stat(name, &st));
+      return st.st_ino;
+    }
+
+    /*
+     * The loop playout against the core chain fed with the TS loop
+     * over and over. The loop lines up after 47 frames, so
+     * PLAYOUT_FRAMES goes around the cache twice, and every frame but
+     * the first (whose CRC-8 can't cover the last packet yet) has to
+     * match. Playing again uses the cache file, another TS rate in
+     * the parameters rebuilds it.
+     */
+    void
+    qa_golden_vectors::t7_loopplayout()
+    {
+      const char *tsfile = "qa_loopplayout.ts";
+      const char *cachefile = "qa_loopplayout.cache";
+      std::vector<unsigned char> loop(PLAYOUT_PACKETS * 188);
+      FILE *fp;
+
+      if (recording()) {
+        return;
+      }
+      lcg_state = 47;
+      for (size_t i = 0; i < loop.size(); i++) {
+        loop[i] = (i % 188) == 0 ? 0x47 : lcg_next() & 0xff;
+      }
+      fp = fopen(tsfile, "wb");
+      CPPUNIT_ASSERT(fp != NULL);
+      CPPUNIT_ASSERT_EQUAL(loop.size(), fwrite(&loop[0], 1, loop.size(), fp));
+      fclose(fp);
+      unlink(cachefile);
+
+      bbframe_encoder::sptr encoder = bbframe_encoder::make(FECFRAME_SHORT, C3_5, INPUTMODE_NORMAL, INBAND_OFF, 1, 0);
+      cell_modulator::sptr modulator = cell_modulator::make(FECFRAME_SHORT, C3_5, MOD_QPSK, ROTATION_OFF);
+      frame_mapper::sptr mapper = frame_mapper::make(FECFRAME_SHORT, C3_5, MOD_QPSK, ROTATION_OFF, 1, 1, CARRIERS_NORMAL, FFTSIZE_1K, GI_1_8, L1_MOD_BPSK, PILOT_PP1, 1, 6, PAPR_OFF, VERSION_131, PREAMBLE_T2_SISO, INPUTMODE_NORMAL, RESERVED_OFF, L1_SCRAMBLED_OFF, INBAND_OFF);
+      ofdm_modulator::sptr ofdm = ofdm_modulator::make(CARRIERS_NORMAL, FFTSIZE_1K, PILOT_PP1, GI_1_8, 6, PAPR_OFF, VERSION_131, PREAMBLE_T2_SISO, MISO_TX1, EQUALIZATION_OFF, BANDWIDTH_8_0_MHZ, 1024);
+      int frame_items = ofdm->output_items();
+      std::vector<unsigned char> ts(encoder->input_items(PLAYOUT_FRAMES));
+      std::vector<unsigned char> fec(encoder->frame_bits() * PLAYOUT_FRAMES);
+      std::vector<gr_complex> cells(modulator->output_items() * PLAYOUT_FRAMES);
+      std::vector<gr_complex> mapped(mapper->output_items() * PLAYOUT_FRAMES);
+      std::vector<gr_complex> reference(frame_items * PLAYOUT_FRAMES);
+      std::vector<gr_complex> out(frame_items * PLAYOUT_FRAMES);
+      std::vector<gr_complex> again(frame_items * PLAYOUT_FRAMES);
+      double energy = 0.0;
+
+      CPPUNIT_ASSERT(mapper->fits());
+      for (size_t i = 0; i < ts.size(); i++) {
+        ts[i] = loop[i % loop.size()];
+      }
+      encoder->process(&ts[0], &fec[0], PLAYOUT_FRAMES);
+      modulator->process(&fec[0], &cells[0], PLAYOUT_FRAMES);
+      mapper->process(&cells[0], &mapped[0], PLAYOUT_FRAMES);
+      ofdm->process(&mapped[0], &reference[0], PLAYOUT_FRAMES);
+      for (size_t i = 0; i < reference.size(); i++) {
+        energy += std::norm(reference[i]);
+      }
+      double rms = std::sqrt(energy / reference.size());
+
+      run_playout(make_playout(tsfile, cachefile, 0), out);
+      for (size_t i = frame_items; i < out.size(); i++) {
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(reference[i].real(), out[i].real(), rms * PILOT_TOLERANCE);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(reference[i].imag(), out[i].imag(), rms * PILOT_TOLERANCE);
+      }
+
+      ino_t inode = file_inode(cachefile);
+      run_playout(make_playout(tsfile, cachefile, 0), again);
+      CPPUNIT_ASSERT(inode == file_inode(cachefile));
+      CPPUNIT_ASSERT(memcmp(&out[0], &again[0], out.size() * sizeof(gr_complex)) == 0);
+      run_playout(make_playout(tsfile, cachefile, 1000000), again);
+      CPPUNIT_ASSERT(inode != file_inode(cachefile));
+      CPPUNIT_ASSERT(memcmp(&out[0], &again[0], out.size() * sizeof(gr_complex)) == 0);
+
+      unlink(tsfile);
+      unlink(cachefile);
+    }
+
+    /*
+     * Every kernel variant the CPU runs against the generic one, on
+     * random data and all lengths up to a few vectors (for the tails),
+     * and the FEC and cell mapping golden vectors with each variant.
+     */
+    void
+    qa_golden_vectors::t8_cpu_kernels()
+    {
+      const cpu_kernels *generic = cpu_kernels_for(CPU_GENERIC);
+      const int lengths = 200;
+      std::vector<unsigned char> src(FRAME_SIZE_NORMAL);
+      std::vector<unsigned char> bytes(FRAME_SIZE_NORMAL);
+      std::vector<unsigned char> expect(FRAME_SIZE_NORMAL);
+      std::vector<unsigned char> result(FRAME_SIZE_NORMAL);
+      std::vector<gr_complex> table(256);
+      std::vector<gr_complex> cells(FRAME_SIZE_NORMAL);
+      std::vector<gr_complex> expect_cells(FRAME_SIZE_NORMAL);
+      std::vector<gr_complex> result_cells(FRAME_SIZE_NORMAL);
+
+      if (recording()) {
+        return;
+      }
+      CPPUNIT_ASSERT(generic != NULL);
+      CPPUNIT_ASSERT(cpu_kernels_for(cpu_arch_supported()) == NULL || cpu_kernels_for(cpu_arch_supported())->arch == cpu_arch_supported());
+      lcg_state = 8;
+      for (size_t i = 0; i < src.size(); i++) {
+        src[i] = lcg_next() & 0xff;
+        bytes[i] = lcg_next() & 0xff;
+      }
+      fill_cells(table);
+      for (int a = CPU_GENERIC; a < CPU_ARCHS; a++) {
+        const cpu_kernels *kernels = cpu_kernels_for((cpu_arch_t)a);
+        if (kernels == NULL) {
+          continue;
+        }
+        for (int n = 0; n <= (int)src.size(); n = (n < lengths ? n + 1 : n * 4 + 3)) {
+          int length = std::min(n, (int)src.size());
+          for (int mask = 0x3; mask <= 0xff; mask = (mask << 2) | 0x3) {
+            memcpy(&expect[0], &bytes[0], length);
+            memcpy(&result[0], &bytes[0], length);
+            generic->xor_bytes(&expect[0], &src[0], length);
+            kernels->xor_bytes(&result[0], &src[0], length);
+            CPPUNIT_ASSERT(memcmp(&expect[0], &result[0], length) == 0);
+            generic->map_cells(&src[0], &table[0], mask, &expect_cells[0], length);
+            kernels->map_cells(&src[0], &table[0], mask, &result_cells[0], length);
+            CPPUNIT_ASSERT(memcmp(&expect_cells[0], &result_cells[0], length * sizeof(gr_complex)) == 0);
+            generic->map_cells_delayed(&src[0], &table[0], mask, &expect_cells[0], length);
+            kernels->map_cells_delayed(&src[0], &table[0], mask, &result_cells[0], length);
+            CPPUNIT_ASSERT(memcmp(&expect_cells[0], &result_cells[0], length * sizeof(gr_complex)) == 0);
+          }
+          if (length == (int)src.size()) {
+            break;
+          }
+        }
+
+        CPPUNIT_ASSERT(cpu_arch_select((cpu_arch_t)a));
+        CPPUNIT_ASSERT_EQUAL(a, (int)cpu_kernels_selected().arch);
+        for (size_t c = 0; c < N_ELEMENTS(bbheader_configs); c++) {
+          const bbheader_config &cfg = bbheader_configs[c];
+          bbframe_encoder::sptr encoder = bbframe_encoder::make(cfg.framesize, cfg.rate, cfg.mode, cfg.inband, cfg.fecblocks, cfg.tsrate);
+          std::vector<unsigned char> in(encoder->input_items(GOLDEN_FRAMES) + 188);
+          std::vector<unsigned char> out(encoder->bch_bits() * GOLDEN_FRAMES);
+          const unsigned char *ts = &in[0];
+
+          lcg_state = c;
+          for (size_t i = 0; i < in.size(); i++) {
+            in[i] = (i % 188) == 0 ? 0x47 : lcg_next() & 0xff;
+          }
+          for (int b = 0; b < GOLDEN_FRAMES; b++) {
+            ts += encoder->encode_frame(ts, &out[b * encoder->bch_bits()]);
+          }
+          CPPUNIT_ASSERT_EQUAL(bbheader_hashes[c], fnv1a(&out[0], out.size()));
+        }
+        for (size_t c = 0; c < N_ELEMENTS(interleavermod_configs); c++) {
+          for (int m = 0; m < INTERLEAVERMOD_MODES; m++) {
+            const interleavermod_config &cfg = interleavermod_configs[c];
+            cell_modulator::sptr modulator = cell_modulator::make(cfg.framesize, cfg.rate, (dvbt2_constellation_t)(m / 2), (m & 0x1) ? ROTATION_ON : ROTATION_OFF);
+            std::vector<unsigned char> in(modulator->input_items() * GOLDEN_FRAMES);
+            std::vector<gr_complex> out(modulator->output_items() * GOLDEN_FRAMES);
+
+            lcg_state = c * INTERLEAVERMOD_MODES + m;
+            for (size_t i = 0; i < in.size(); i++) {
+              in[i] = lcg_next() & 0x1;
+            }
+            modulator->process(&in[0], &out[0], GOLDEN_FRAMES);
+            CPPUNIT_ASSERT_EQUAL(interleavermod_hashes[c * INTERLEAVERMOD_MODES + m], fnv1a(&out[0], out.size() * sizeof(gr_complex)));
+          }
+        }
+      }
+      /* back to the highest variant for the tests that follow */
+      for (int a = CPU_ARCHS - 1; a > CPU_GENERIC; a--) {
+        if (cpu_arch_select((cpu_arch_t)a)) {
+          break;
+        }
+      }
+    }
+
+
+    /*
+     * Small buffers from the heap and huge page sized ones mapped on
+     * their own, both aligned, whole and freed again.
+     */
+    void
+    qa_golden_vectors::t9_frame_buffer()
+    {
+      const size_t sizes[] = {1, 1000, HUGE_PAGE_SIZE - FRAME_BUFFER_ALIGN, HUGE_PAGE_SIZE, (5 * HUGE_PAGE_SIZE) + 3};
+
+      for (size_t i = 0; i < N_ELEMENTS(sizes); i++) {
+        unsigned char *buffer = (unsigned char *) frame_buffer_alloc(sizes[i]);
+
+        CPPUNIT_ASSERT(buffer != NULL);
+        CPPUNIT_ASSERT_EQUAL((uintptr_t)0, (uintptr_t)buffer % FRAME_BUFFER_ALIGN);
+        memset(buffer, 0xa5, sizes[i]);
+        CPPUNIT_ASSERT_EQUAL(0xa5, (int)buffer[sizes[i] - 1]);
+        if (sizes[i] < HUGE_PAGE_SIZE) {
+          CPPUNIT_ASSERT(!frame_buffer_place(buffer, 0));
+        }
+        frame_buffer_free(buffer);
+      }
+      frame_buffer_free(NULL);
+
+      std::vector<gr_complex, frame_allocator<gr_complex> > cells(HUGE_PAGE_SIZE / sizeof(gr_complex));
+      CPPUNIT_ASSERT_EQUAL((uintptr_t)0, (uintptr_t)&cells[0] % FRAME_BUFFER_ALIGN);
+      CPPUNIT_ASSERT(cells.back() == gr_complex(0.0, 0.0));
+      cells.resize(cells.size() * 2, gr_complex(1.0, 0.0));
+      CPPUNIT_ASSERT_EQUAL((uintptr_t)0, (uintptr_t)&cells[0] % FRAME_BUFFER_ALIGN);
+      CPPUNIT_ASSERT(cells.back() == gr_complex(1.0, 0.0));
+    }
+
+    /* 10 log10 of the power of ref over that of the difference */
+    static double
+    sc16_snr(const std::vector<gr_complex> &ref, const std::vector<lv_16sc_t> &out, float scale)
+    {
+      double signal = 0.0;
+      double noise = 0.0;
+
+      for (size_t i = 0; i < ref.size(); i++) {
+        gr_complex value = ref[i] * scale;
+        signal += std::norm(value);
+        noise += std::norm(value - gr_complex(out[i].real(), out[i].imag()));
+      }
+      return 10.0 * std::log10(signal / noise);
+    }
+
+    /*
+     * The sc16 cell format against the float chain: the MER of the
+     * Q2.13 cells of every constellation, the frame mapper moving
+     * them bit-exactly, and the SNR of the sc16 I/Q. The blocks must
+     * match the core classes. Not run when recording.
+     */
+    void
+    qa_golden_vectors::t10_fixed_point()
+    {
+      double worst = 1000.0;
+
+      if (recording()) {
+        return;
+      }
+      for (size_t c = 0; c < N_ELEMENTS(interleavermod_configs); c++) {
+        for (int m = 0; m < INTERLEAVERMOD_MODES; m++) {
+          const interleavermod_config &cfg = interleavermod_configs[c];
+          dvbt2_constellation_t constellation = (dvbt2_constellation_t)(m / 2);
+          dvbt2_rotation_t rotation = (m & 0x1) ? ROTATION_ON : ROTATION_OFF;
+          cell_modulator::sptr modulator = cell_modulator::make(cfg.framesize, cfg.rate, constellation, rotation);
+          std::vector<unsigned char> in(modulator->input_items() * GOLDEN_FRAMES);
+          std::vector<gr_complex> ref(modulator->output_items() * GOLDEN_FRAMES);
+          std::vector<lv_16sc_t> out(ref.size());
+
+          lcg_state = c * INTERLEAVERMOD_MODES + m;
+          for (size_t i = 0; i < in.size(); i++) {
+            in[i] = lcg_next() & 0x1;
+          }
+          modulator->process(&in[0], &ref[0], GOLDEN_FRAMES);
+          CPPUNIT_ASSERT_EQUAL((int)in.size(), modulator->process(&in[0], &out[0], GOLDEN_FRAMES));
+          worst = std::min(worst, sc16_snr(ref, out, CELL_SC16_SCALE));
+          if (c == 0) {
+            interleavermod_bc::sptr blk = interleavermod_bc::make(cfg.framesize, cfg.rate, constellation, rotation, CELLFORMAT_SC16);
+            std::vector<lv_16sc_t> blk_out(out.size());
+
+            run_block(blk, in, blk_out);
+            CPPUNIT_ASSERT(blk_out == out);
+          }
+        }
+      }
+      CPPUNIT_ASSERT(worst > SC16_CELL_MER);
+
+      worst = 1000.0;
+      for (size_t c = 0; c < N_ELEMENTS(frame_configs); c++) {
+        const frame_config &cfg = frame_configs[c];
+        dvbt2_misogroup_t misogroup = cfg.preamble == PREAMBLE_T2_MISO ? MISO_TX2 : MISO_TX1;
+        frame_mapper::sptr mapper = frame_mapper::make(cfg.framesize, cfg.rate, cfg.constellation, ROTATION_OFF, cfg.fecblocks, cfg.tiblocks, cfg.carriermode, cfg.fftsize, cfg.guardinterval, cfg.l1constellation, cfg.pilotpattern, cfg.t2frames, cfg.numdatasyms, cfg.paprmode, VERSION_131, cfg.preamble, INPUTMODE_NORMAL, RESERVED_OFF, cfg.l1scrambled, INBAND_OFF);
+        frame_mapper::sptr mapper_sc16 = frame_mapper::make(cfg.framesize, cfg.rate, cfg.constellation, ROTATION_OFF, cfg.fecblocks, cfg.tiblocks, cfg.carriermode, cfg.fftsize, cfg.guardinterval, cfg.l1constellation, cfg.pilotpattern, cfg.t2frames, cfg.numdatasyms, cfg.paprmode, VERSION_131, cfg.preamble, INPUTMODE_NORMAL, RESERVED_OFF, cfg.l1scrambled, INBAND_OFF);
+        ofdm_modulator::sptr ofdm = ofdm_modulator::make(cfg.carriermode, cfg.fftsize, cfg.pilotpattern, cfg.guardinterval, cfg.numdatasyms, cfg.paprmode, VERSION_131, cfg.preamble, misogroup, cfg.equalization, cfg.bandwidth, cfg.vlength);
+        std::vector<gr_complex> in(mapper->input_items() * GOLDEN_FRAMES);
+        std::vector<gr_complex> mapped(mapper->output_items() * GOLDEN_FRAMES);
+        std::vector<gr_complex> ref(ofdm->output_items() * GOLDEN_FRAMES);
+        std::vector<lv_16sc_t> in_sc16(in.size());
+        std::vector<lv_16sc_t> expected(mapped.size());
+        std::vector<lv_16sc_t> mapped_sc16(mapped.size());
+        std::vector<lv_16sc_t> out(ref.size());
+        std::vector<lv_16sc_t> blk_mapped(mapped.size());
+        std::vector<lv_16sc_t> blk_out(out.size());
+
+        lcg_state = c;
+        fill_cells(in);
+        cells_to_sc16(&in[0], &in_sc16[0], in.size());
+        mapper->process(&in[0], &mapped[0], GOLDEN_FRAMES);
+        CPPUNIT_ASSERT_EQUAL((int)in.size(), mapper_sc16->process(&in_sc16[0], &mapped_sc16[0], GOLDEN_FRAMES));
+        cells_to_sc16(&mapped[0], &expected[0], mapped.size());
+        CPPUNIT_ASSERT(mapped_sc16 == expected);
+        ofdm->process(&mapped[0], &ref[0], GOLDEN_FRAMES);
+        CPPUNIT_ASSERT_EQUAL((int)mapped.size(), ofdm->process(&mapped_sc16[0], &out[0], GOLDEN_FRAMES));
+        worst = std::min(worst, sc16_snr(ref, out, SC16_SCALE));
+
+        framemapperfint_cc::sptr mapper_blk = framemapperfint_cc::make(cfg.framesize, cfg.rate, cfg.constellation, ROTATION_OFF, cfg.fecblocks, cfg.tiblocks, cfg.carriermode, cfg.fftsize, cfg.guardinterval, cfg.l1constellation, cfg.pilotpattern, cfg.t2frames, cfg.numdatasyms, cfg.paprmode, VERSION_131, cfg.preamble, INPUTMODE_NORMAL, RESERVED_OFF, cfg.l1scrambled, INBAND_OFF, 0, 1, PIPELINE_OFF, CELLFORMAT_SC16);
+        pilotgenp1insert_cc::sptr ofdm_blk = pilotgenp1insert_cc::make(cfg.carriermode, cfg.fftsize, cfg.pilotpattern, cfg.guardinterval, cfg.numdatasyms, cfg.paprmode, VERSION_131, cfg.preamble, misogroup, cfg.equalization, cfg.bandwidth, cfg.vlength, 0, 1, CELLFORMAT_SC16);
+        run_block(mapper_blk, in_sc16, blk_mapped);
+        CPPUNIT_ASSERT(blk_mapped == mapped_sc16);
+        run_block(ofdm_blk, mapped_sc16, blk_out);
+        CPPUNIT_ASSERT(blk_out == out);
+      }
+      CPPUNIT_ASSERT(worst > SC16_IQ_SNR);
+    }
+
+    /* The modified Alamouti pairs of MISO Tx2, within each symbol */
+    static void
+    alamouti_cells(const ofdm_modulator_impl &ofdm, std::vector<gr_complex> &cells)
+    {
+      gr_complex *cell = &cells[0];
+      gr_complex first;
+
+      for (size_t f = 0; f < cells.size() / ofdm.input_items(); f++) {
+        for (int j = 0; j < ofdm.symbols(); j++) {
+          for (int k = 0; k + 1 < ofdm.symbol_cells(j); k += 2) {
+            first = cell[k];
+            cell[k] = -std::conj(cell[k + 1]);
+            cell[k + 1] = std::conj(first);
+          }
+          cell += ofdm.symbol_cells(j);
+        }
+      }
+    }
+
+    /*
+     * MISO_TX1_TX2 against one MISO_TX1 and one MISO_TX2 modulator,
+     * the latter fed with the Alamouti pairs, for both cell formats
+     * and the block. Not run when recording.
+     */
+    void
+    qa_golden_vectors::t11_miso_dual()
+    {
+      if (recording()) {
+        return;
+      }
+      for (size_t c = 0; c < N_ELEMENTS(frame_configs); c++) {
+        const frame_config &cfg = frame_configs[c];
+        if (cfg.preamble != PREAMBLE_T2_MISO) {
+          continue;
+        }
+        ofdm_modulator_impl tx1(cfg.carriermode, cfg.fftsize, cfg.pilotpattern, cfg.guardinterval, cfg.numdatasyms, cfg.paprmode, VERSION_131, cfg.preamble, MISO_TX1, cfg.equalization, cfg.bandwidth, cfg.vlength);
+        ofdm_modulator_impl tx2(cfg.carriermode, cfg.fftsize, cfg.pilotpattern, cfg.guardinterval, cfg.numdatasyms, cfg.paprmode, VERSION_131, cfg.preamble, MISO_TX2, cfg.equalization, cfg.bandwidth, cfg.vlength);
+        ofdm_modulator::sptr dual = ofdm_modulator::make(cfg.carriermode, cfg.fftsize, cfg.pilotpattern, cfg.guardinterval, cfg.numdatasyms, cfg.paprmode, VERSION_131, cfg.preamble, MISO_TX1_TX2, cfg.equalization, cfg.bandwidth, cfg.vlength);
+        pilotgenp1insert_cc::sptr blk = pilotgenp1insert_cc::make(cfg.carriermode, cfg.fftsize, cfg.pilotpattern, cfg.guardinterval, cfg.numdatasyms, cfg.paprmode, VERSION_131, cfg.preamble, MISO_TX1_TX2, cfg.equalization, cfg.bandwidth, cfg.vlength);
+        std::vector<gr_complex> cells(tx1.input_items() * GOLDEN_FRAMES);
+        std::vector<gr_complex> pairs;
+        std::vector<gr_complex> ref1(tx1.output_items() * GOLDEN_FRAMES);
+        std::vector<gr_complex> ref2(ref1.size());
+        std::vector<gr_complex> out1(ref1.size());
+        std::vector<gr_complex> out2(ref1.size());
+        std::vector<lv_16sc_t> cells_sc16(cells.size());
+        std::vector<lv_16sc_t> pairs_sc16(cells.size());
+        std::vector<lv_16sc_t> ref1_sc16(ref1.size());
+        std::vector<lv_16sc_t> ref2_sc16(ref1.size());
+        std::vector<lv_16sc_t> out1_sc16(ref1.size());
+        std::vector<lv_16sc_t> out2_sc16(ref1.size());
+
+        lcg_state = c;
+        fill_cells(cells);
+        pairs = cells;
+        alamouti_cells(tx1, pairs);
+        tx1.process(&cells[0], &ref1[0], GOLDEN_FRAMES);
+        tx2.process(&pairs[0], &ref2[0], GOLDEN_FRAMES);
+        CPPUNIT_ASSERT(ref1 != ref2);
+        CPPUNIT_ASSERT_EQUAL((int)cells.size(), dual->process(&cells[0], &out1[0], &out2[0], GOLDEN_FRAMES));
+        CPPUNIT_ASSERT(out1 == ref1);
+        CPPUNIT_ASSERT(out2 == ref2);
+        CPPUNIT_ASSERT_THROW(dual->process(&cells[0], &out1[0], GOLDEN_FRAMES), std::invalid_argument);
+
+        cells_to_sc16(&cells[0], &cells_sc16[0], cells.size());
+        cells_to_sc16(&pairs[0], &pairs_sc16[0], cells.size());
+        tx1.process(&cells_sc16[0], &ref1_sc16[0], GOLDEN_FRAMES);
+        tx2.process(&pairs_sc16[0], &ref2_sc16[0], GOLDEN_FRAMES);
+        dual->process(&cells_sc16[0], &out1_sc16[0], &out2_sc16[0], GOLDEN_FRAMES);
+        CPPUNIT_ASSERT(out1_sc16 == ref1_sc16);
+        CPPUNIT_ASSERT(out2_sc16 == ref2_sc16);
+
+        run_block(blk, cells, out1, &out2);
+        CPPUNIT_ASSERT(out1 == ref1);
+        CPPUNIT_ASSERT(out2 == ref2);
+      }
+    }
+
+    /* Field of length bits at bit offset of a byte string, MSB first */
+    static uint64_t
+    get_bits(const unsigned char *bytes, int offset, int length)
+    {
+      uint64_t value = 0;
+
+      for (int n = 0; n < length; n++, offset++) {
+        value = (value << 1) | ((bytes[offset / 8] >> (7 - (offset % 8))) & 0x1);
+      }
+      return value;
+    }
+
+    /* MPEG-2 CRC-32, 0 over a whole T2-MI packet with its CRC */
+    static uint32_t
+    crc32_bytes(const unsigned char *bytes, int length)
+    {
+      uint32_t crc = 0xffffffff;
+
+      for (int i = 0; i < length; i++) {
+        crc ^= (uint32_t)bytes[i] << 24;
+        for (int n = 0; n < 8; n++) {
+          crc = crc & 0x80000000 ? (crc << 1) ^ 0x04c11db7 : crc << 1;
+        }
+      }
+      return crc;
+    }
+
+    /*
+     * Takes the T2-MI packets out of the TS of the encapsulator and
+     * checks them against the BBFRAMEs that went in, the L1 of the
+     * frame mapper and the length of a T2 frame.
+     */
+    void
+    qa_golden_vectors::t12_t2mi()
+    {
+      /* Elementary period T of each bandwidth, in us */
+      static const double periods[6] = {71.0 / 131.0, 7.0 / 40.0, 7.0 / 48.0, 1.0 / 8.0, 7.0 / 64.0, 7.0 / 80.0};
+
+      std::vector<frame_config> configs(frame_configs, frame_configs + N_ELEMENTS(frame_configs));
+      int stuffed = 0;
+
+      if (recording()) {
+        return;
+      }
+      configs.insert(configs.end(), t2mi_configs, t2mi_configs + N_ELEMENTS(t2mi_configs));
+      for (size_t c = 0; c < configs.size(); c++) {
+        const frame_config &cfg = configs[c];
+        int frames = cfg.t2frames + 1;
+        bbframe_encoder::sptr encoder = bbframe_encoder::make(cfg.framesize, cfg.rate, INPUTMODE_NORMAL, INBAND_OFF, cfg.fecblocks, 0);
+        frame_mapper_impl mapper(cfg.framesize, cfg.rate, cfg.constellation, ROTATION_ON, cfg.fecblocks, cfg.tiblocks, cfg.carriermode, cfg.fftsize, cfg.guardinterval, cfg.l1constellation, cfg.pilotpattern, cfg.t2frames, cfg.numdatasyms, cfg.paprmode, VERSION_131, cfg.preamble, INPUTMODE_NORMAL, RESERVED_OFF, cfg.l1scrambled, INBAND_OFF);
+        ofdm_modulator::sptr ofdm = ofdm_modulator::make(cfg.carriermode, cfg.fftsize, cfg.pilotpattern, cfg.guardinterval, cfg.numdatasyms, cfg.paprmode, VERSION_131, cfg.preamble, MISO_TX1, cfg.equalization, cfg.bandwidth, cfg.vlength);
+        t2miencap_bb::sptr blk = t2miencap_bb::make(cfg.framesize, cfg.rate, cfg.constellation, ROTATION_ON, cfg.fecblocks, cfg.tiblocks, cfg.carriermode, cfg.fftsize, cfg.guardinterval, cfg.l1constellation, cfg.pilotpattern, cfg.t2frames, cfg.numdatasyms, cfg.paprmode, VERSION_131, cfg.preamble, INPUTMODE_NORMAL, RESERVED_OFF, cfg.l1scrambled, INBAND_OFF, cfg.bandwidth, T2MI_PID);
+        int nbch = encoder->bch_bits();
+        int blocks = cfg.fecblocks * frames;
+        std::vector<unsigned char> ts(encoder->input_items(blocks) + 188);
+        std::vector<unsigned char> bbframes(nbch * blocks);
+        std::vector<unsigned char> out(blk->output_multiple() * frames);
+        std::vector<unsigned char> data;
+        std::vector<size_t> starts;
+        std::vector<size_t> parsed;
+        std::vector<unsigned char> pre(KBCH_1_2);
+        std::vector<unsigned char> post(KBCH_1_2);
+        double begin, end;
+        int pre_bits, post_bits, conf_bits, kbch, frame, block, count, length, offset;
+        uint64_t stamp_seconds = 0, stamp_periods = 0, seconds, subseconds;
+        size_t pos, next;
+        const unsigned char *ts_packet, *packet;
+
+        lcg_state = c;
+        for (size_t i = 0; i < ts.size(); i++) {
+          ts[i] = (i % 188) == 0 ? 0x47 : lcg_next() & 0xff;
+        }
+        pos = 0;
+        for (int i = 0; i < blocks; i++) {
+          pos += encoder->encode_frame(&ts[pos], &bbframes[i * nbch]);
+        }
+        begin = std::chrono::duration<double>(std::chrono::system_clock::now().time_since_epoch()).count();
+        run_block(blk, bbframes, out);
+        end = std::chrono::duration<double>(std::chrono::system_clock::now().time_since_epoch()).count();
+
+        /* TS layer, with PUSI marking where a T2-MI packet starts */
+        CPPUNIT_ASSERT_EQUAL(0, (int)(out.size() % 188));
+        for (size_t i = 0; i < out.size() / 188; i++) {
+          ts_packet = &out[i * 188];
+          CPPUNIT_ASSERT_EQUAL(0x47, (int)ts_packet[0]);
+          CPPUNIT_ASSERT_EQUAL(T2MI_PID, ((ts_packet[1] & 0x1f) << 8) | ts_packet[2]);
+          CPPUNIT_ASSERT_EQUAL((int)(i & 0xf), ts_packet[3] & 0xf);
+          offset = 4;
+          if ((ts_packet[3] & 0x30) == 0x30) {
+            offset += 1 + ts_packet[4];
+            stuffed++;
+          }
+          if (ts_packet[1] & 0x40) {
+            CPPUNIT_ASSERT(ts_packet[offset] < 188 - offset - 1);
+            starts.push_back(data.size() + ts_packet[offset]);
+            offset++;
+          }
+          data.insert(data.end(), ts_packet + offset, ts_packet + 188);
+        }
+
+        /* T2-MI packets, back to back up to the 0xff stuffing at the end of a frame */
+        pre_bits = mapper.l1pre_bits(mapper.config(), &pre[0]);
+        kbch = -1;
+        count = 0;
+        pos = starts[0];
+        for (frame = 0; frame < frames; frame++) {
+          for (int p = 0; p < cfg.fecblocks + 2; p++) {
+            CPPUNIT_ASSERT(pos + 6 <= data.size());
+            packet = &data[pos];
+            length = 6 + ((get_bits(packet, 32, 16) + 7) / 8) + 4;
+            CPPUNIT_ASSERT(pos + length <= data.size());
+            CPPUNIT_ASSERT_EQUAL(0u, crc32_bytes(packet, length));
+            CPPUNIT_ASSERT_EQUAL((uint64_t)(count++ & 0xff), get_bits(packet, 8, 8));
+            CPPUNIT_ASSERT_EQUAL((uint64_t)((frame / cfg.t2frames) & 0xf), get_bits(packet, 16, 4));
+            block = (frame * cfg.fecblocks) + p;
+            if (p < cfg.fecblocks) {
+              /* BBFRAME, descrambled: MATYPE of a single CCM TS and DFL */
+              CPPUNIT_ASSERT_EQUAL((uint64_t)0x00, get_bits(packet, 0, 8));
+              CPPUNIT_ASSERT_EQUAL((uint64_t)(frame % cfg.t2frames), get_bits(packet, 48, 8));
+              CPPUNIT_ASSERT_EQUAL((uint64_t)(p == 0), get_bits(packet, 64, 1));
+              if (kbch < 0) {
+                kbch = get_bits(packet, 32, 16) - 24;
+              }
+              CPPUNIT_ASSERT_EQUAL((uint64_t)(kbch + 24), get_bits(packet, 32, 16));
+              CPPUNIT_ASSERT_EQUAL((uint64_t)0xf0, get_bits(packet, 72, 8));
+              CPPUNIT_ASSERT_EQUAL((uint64_t)(kbch - 80), get_bits(packet, 72 + 32, 16));
+              for (int i = 0; i < kbch; i++) {
+                CPPUNIT_ASSERT_EQUAL((uint64_t)(bbframes[(block * nbch) + i] ^ bb_prbs[i]), get_bits(packet, 72 + i, 1));
+              }
+            }
+            else if (p == cfg.fecblocks) {
+              /* timestamp, one T2 frame after the last */
+              CPPUNIT_ASSERT_EQUAL((uint64_t)0x20, get_bits(packet, 0, 8));
+              CPPUNIT_ASSERT_EQUAL((uint64_t)cfg.bandwidth, get_bits(packet, 52, 4));
+              CPPUNIT_ASSERT_EQUAL((uint64_t)5, get_bits(packet, 123, 13));
+              seconds = get_bits(packet, 56, 40);
+              subseconds = get_bits(packet, 96, 27);
+              CPPUNIT_ASSERT(subseconds * periods[cfg.bandwidth] < 1e6);
+              if (frame == 0) {
+                CPPUNIT_ASSERT(seconds >= (uint64_t)(begin + 1.0) - UNIX_TIME_2000 + 5);
+                CPPUNIT_ASSERT(seconds <= (uint64_t)(end + 2.0) - UNIX_TIME_2000 + 5);
+                CPPUNIT_ASSERT_EQUAL((uint64_t)0, subseconds);
+              }
+              else {
+                CPPUNIT_ASSERT(std::fabs(((seconds - stamp_seconds) * 1e6) + ((subseconds - (double)stamp_periods) * periods[cfg.bandwidth]) - (ofdm->output_items() * periods[cfg.bandwidth])) < periods[cfg.bandwidth]);
+              }
+              stamp_seconds = seconds;
+              stamp_periods = subseconds;
+            }
+            else {
+              /* L1-current: L1-pre, L1CONF and L1DYN_CURR of the frame mapper */
+              CPPUNIT_ASSERT_EQUAL((uint64_t)0x10, get_bits(packet, 0, 8));
+              CPPUNIT_ASSERT_EQUAL((uint64_t)(frame % cfg.t2frames), get_bits(packet, 48, 8));
+              post_bits = mapper.l1post_bits(mapper.config(), &post[0], frame % cfg.t2frames, conf_bits);
+              CPPUNIT_ASSERT_EQUAL((uint64_t)(16 + pre_bits + 16 + post_bits + 32), get_bits(packet, 32, 16));
+              offset = 64;
+              for (int i = 0; i < pre_bits; i++) {
+                CPPUNIT_ASSERT_EQUAL((uint64_t)pre[i], get_bits(packet, offset++, 1));
+              }
+              CPPUNIT_ASSERT_EQUAL((uint64_t)conf_bits, get_bits(packet, offset, 16));
+              offset += 16;
+              for (int i = 0; i < conf_bits; i++) {
+                CPPUNIT_ASSERT_EQUAL((uint64_t)post[i], get_bits(packet, offset++, 1));
+              }
+              CPPUNIT_ASSERT_EQUAL((uint64_t)(post_bits - conf_bits), get_bits(packet, offset, 16));
+              offset += 16;
+              CPPUNIT_ASSERT_EQUAL((uint64_t)(frame % cfg.t2frames), get_bits(packet, offset, 8));
+              for (int i = conf_bits; i < post_bits; i++) {
+                CPPUNIT_ASSERT_EQUAL((uint64_t)post[i], get_bits(packet, offset++, 1));
+              }
+              CPPUNIT_ASSERT_EQUAL((uint64_t)0, get_bits(packet, offset, 16));
+            }
+            parsed.push_back(pos);
+            pos += length;
+          }
+          /* stuffing up to the next PUSI */
+          next = std::lower_bound(starts.begin(), starts.end(), pos) - starts.begin();
+          while (pos < data.size() && (next == starts.size() || pos < starts[next])) {
+            CPPUNIT_ASSERT_EQUAL(0xff, (int)data[pos++]);
+          }
+        }
+        CPPUNIT_ASSERT_EQUAL(data.size(), pos);
+        for (size_t i = 0; i < starts.size(); i++) {
+          CPPUNIT_ASSERT(std::find(parsed.begin(), parsed.end(), starts[i]) != parsed.end());
+        }
+      }
+      CPPUNIT_ASSERT(stuffed > 0);
+    }
+
+  } /* namespace dvbt2ll */
+} /* namespace gr */
@@ -0,0 +1,74 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2017 Ron Economos.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef _QA_GOLDEN_VECTORS_H_
+#define _QA_GOLDEN_VECTORS_H_
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestCase.h>
+
+namespace gr {
+  namespace dvbt2ll {
+
+    /*
+     * Checks the output of every block against reference vectors,
+     * bit-exactly for the bit and cell stages and within a float
+     * tolerance after the IFFT.
+     *
+     * Set DVBT2LL_GOLDEN_RECORD=1 to print the reference tables from
+     * the current code instead of checking them.
+     */
+    class qa_golden_vectors : public CppUnit::TestCase
+    {
+    public:
+      CPPUNIT_TEST_SUITE(qa_golden_vectors);
+      CPPUNIT_TEST(t1_bbheaderbch);
+      CPPUNIT_TEST(t2_interleavermod);
+      CPPUNIT_TEST(t3_framemapperfint);
+      CPPUNIT_TEST(t4_pilotgenp1insert);
+      CPPUNIT_TEST(t5_transmitter);
+      CPPUNIT_TEST(t6_core);
+      CPPUNIT_TEST(t7_loopplayout);
+      CPPUNIT_TEST(t8_cpu_kernels);
+      CPPUNIT_TEST(t9_frame_buffer);
+      CPPUNIT_TEST(t10_fixed_point);
+      CPPUNIT_TEST(t11_miso_dual);
+      CPPUNIT_TEST(t12_t2mi);
+      CPPUNIT_TEST_SUITE_END();
+
+    private:
+      void t1_bbheaderbch();
+      void t2_interleavermod();
+      void t3_framemapperfint();
+      void t4_pilotgenp1insert();
+      void t5_transmitter();
+      void t6_core();
+      void t7_loopplayout();
+      void t8_cpu_kernels();
+      void t9_frame_buffer();
+      void t10_fixed_point();
+      void t11_miso_dual();
+      void t12_t2mi();
+    };
+
+  } /* namespace dvbt2ll */
+} /* namespace gr */
+
+#endif /* _QA_GOLDEN_VECTORS_H_ */
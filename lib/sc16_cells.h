@@ -0,0 +1,57 @@
+/* -*- c++ -*- */
+/* 
+ * Copyright 2017 Ron Economos.
+ * 
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ * 
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_DVBT2LL_SC16_CELLS_H
+#define INCLUDED_DVBT2LL_SC16_CELLS_H
+
+#include <dvbt2ll/dvbt2ll_config.h>
+#include <gnuradio/gr_complex.h>
+#include <volk/volk_complex.h>
+#include <math.h>
+#include <stdint.h>
+
+namespace gr {
+  namespace dvbt2ll {
+
+    /* Q2.13 cells of the sc16 cell path, see CELL_SC16_SCALE */
+    static inline lv_16sc_t
+    cell_to_sc16(const gr_complex &cell)
+    {
+      return lv_16sc_t((int16_t)lrintf(cell.real() * CELL_SC16_SCALE), (int16_t)lrintf(cell.imag() * CELL_SC16_SCALE));
+    }
+
+    static inline gr_complex
+    cell_from_sc16(const lv_16sc_t &cell)
+    {
+      return gr_complex(cell.real() * (1.0f / CELL_SC16_SCALE), cell.imag() * (1.0f / CELL_SC16_SCALE));
+    }
+
+    static inline void
+    cells_to_sc16(const gr_complex *in, lv_16sc_t *out, int length)
+    {
+      for (int i = 0; i < length; i++) {
+        out[i] = cell_to_sc16(in[i]);
+      }
+    }
+
+  } // namespace dvbt2ll
+} // namespace gr
+
+#endif /* INCLUDED_DVBT2LL_SC16_CELLS_H */
@@ -0,0 +1,480 @@
+/* -*- c++ -*- */
+/* 
+ * Copyright 2017 Ron Economos.
+ * 
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ * 
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gnuradio/io_signature.h>
+#include "t2miencap_bb_impl.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <string.h>
+
+namespace gr {
+  namespace dvbt2ll {
+
+    t2miencap_bb::sptr
+    t2miencap_bb::make(dvbt2_framesize_t framesize, dvbt2_code_rate_t rate, dvbt2_constellation_t constellation, dvbt2_rotation_t rotation, int fecblocks, int tiblocks, dvbt2_extended_carrier_t carriermode, dvbt2_fftsize_t fftsize, dvbt2_guardinterval_t guardinterval, dvbt2_l1constellation_t l1constellation, dvbt2_pilotpattern_t pilotpattern, int t2frames, int numdatasyms, dvbt2_papr_t paprmode, dvbt2_version_t version, dvbt2_preamble_t preamble, dvbt2_inputmode_t inputmode, dvbt2_reservedbiasbits_t reservedbiasbits, dvbt2_l1scrambled_t l1scrambled, dvbt2_inband_t inband, dvbt2_bandwidth_t bandwidth, int pid, double delay, int utco)
+    {
+      return gnuradio::get_initial_sptr
+        (new t2miencap_bb_impl(framesize, rate, constellation, rotation, fecblocks, tiblocks, carriermode, fftsize, guardinterval, l1constellation, pilotpattern, t2frames, numdatasyms, paprmode, version, preamble, inputmode, reservedbiasbits, l1scrambled, inband, bandwidth, pid, delay, utco));
+    }
+
+    /*
+     * The private constructor
+     */
+    t2miencap_bb_impl::t2miencap_bb_impl(dvbt2_framesize_t framesize, dvbt2_code_rate_t rate, dvbt2_constellation_t constellation, dvbt2_rotation_t rotation, int fecblocks, int tiblocks, dvbt2_extended_carrier_t carriermode, dvbt2_fftsize_t fftsize, dvbt2_guardinterval_t guardinterval, dvbt2_l1constellation_t l1constellation, dvbt2_pilotpattern_t pilotpattern, int t2frames, int numdatasyms, dvbt2_papr_t paprmode, dvbt2_version_t version, dvbt2_preamble_t preamble, dvbt2_inputmode_t inputmode, dvbt2_reservedbiasbits_t reservedbiasbits, dvbt2_l1scrambled_t l1scrambled, dvbt2_inband_t inband, dvbt2_bandwidth_t bandwidth, int pid, double delay, int utco)
+      : gr::block("t2miencap_bb",
+              gr::io_signature::make(1, 1, sizeof(unsigned char)),
+              gr::io_signature::make(1, 1, sizeof(unsigned char))),
+        mapper(framesize, rate, constellation, rotation, fecblocks, tiblocks, carriermode, fftsize, guardinterval, l1constellation, pilotpattern, t2frames, numdatasyms, paprmode, version, preamble, inputmode, reservedbiasbits, l1scrambled, inband)
+    {
+      int fft_points = 0;
+      int guard_interval = 0;
+      int pre_bits, post_bits, conf_bits, offset;
+
+      if (!mapper.fits()) {
+        GR_LOG_WARN(d_logger, "T2-MI Encapsulator, too many FEC blocks in T2 frame.");
+      }
+      kernels = &cpu_kernels_selected();
+      if (framesize == FECFRAME_NORMAL) {
+        switch (rate) {
+          case C1_2:
+            kbch = 32208;
+            nbch = 32400;
+            break;
+          case C3_5:
+            kbch = 38688;
+            nbch = 38880;
+            break;
+          case C2_3:
+            kbch = 43040;
+            nbch = 43200;
+            break;
+          case C3_4:
+            kbch = 48408;
+            nbch = 48600;
+            break;
+          case C4_5:
+            kbch = 51648;
+            nbch = 51840;
+            break;
+          case C5_6:
+            kbch = 53840;
+            nbch = 54000;
+            break;
+          default:
+            kbch = 0;
+            nbch = 0;
+            break;
+        }
+      }
+      else {
+        switch (rate) {
+          case C1_3:
+            kbch = 5232;
+            nbch = 5400;
+            break;
+          case C2_5:
+            kbch = 6312;
+            nbch = 6480;
+            break;
+          case C1_2:
+            kbch = 7032;
+            nbch = 7200;
+            break;
+          case C3_5:
+            kbch = 9552;
+            nbch = 9720;
+            break;
+          case C2_3:
+            kbch = 10632;
+            nbch = 10800;
+            break;
+          case C3_4:
+            kbch = 11712;
+            nbch = 11880;
+            break;
+          case C4_5:
+            kbch = 12432;
+            nbch = 12600;
+            break;
+          case C5_6:
+            kbch = 13152;
+            nbch = 13320;
+            break;
+          default:
+            kbch = 0;
+            nbch = 0;
+            break;
+        }
+      }
+      fec_blocks = fecblocks;
+      t2_frames = t2frames;
+      frame_bits = fec_blocks * nbch;
+      ts_pid = pid & 0x1fff;
+      continuity = 0;
+      packet_count = 0;
+      superframe_idx = 0;
+      frame_idx = 0;
+
+      /* a BBFRAME packet is the longest one */
+      packet.resize(T2MI_HEADER_BITS + 24 + kbch + 7 + T2MI_CRC_BITS);
+      l1_bits.resize(KBCH_1_2);
+      pre_bits = mapper.l1pre_bits(mapper.config(), &l1_bits[0]);
+      post_bits = mapper.l1post_bits(mapper.config(), &l1_bits[0], 0, conf_bits);
+      offset = 0;
+      for (int i = 0; i < fec_blocks; i++) {
+        packet_starts.push_back(offset);
+        offset += packet_bytes(24 + kbch);
+      }
+      packet_starts.push_back(offset);
+      offset += packet_bytes(T2MI_TIMESTAMP_BITS);
+      packet_starts.push_back(offset);
+      offset += packet_bytes(16 + pre_bits + 16 + post_bits + 32);
+      data_length = offset;
+      frame_data.resize(data_length);
+      frame_items = ts_packets(NULL) * TS_PACKET_SIZE;
+      set_output_multiple(frame_items);
+
+      switch (fftsize) {
+        case FFTSIZE_1K:
+          fft_points = 1024;
+          break;
+        case FFTSIZE_2K:
+          fft_points = 2048;
+          break;
+        case FFTSIZE_4K:
+          fft_points = 4096;
+          break;
+        case FFTSIZE_8K:
+        case FFTSIZE_8K_T2GI:
+          fft_points = 8192;
+          break;
+        case FFTSIZE_16K:
+        case FFTSIZE_16K_T2GI:
+          fft_points = 16384;
+          break;
+        case FFTSIZE_32K:
+        case FFTSIZE_32K_T2GI:
+          fft_points = 32768;
+          break;
+      }
+      switch (guardinterval) {
+        case GI_1_32:
+          guard_interval = fft_points / 32;
+          break;
+        case GI_1_16:
+          guard_interval = fft_points / 16;
+          break;
+        case GI_1_8:
+          guard_interval = fft_points / 8;
+          break;
+        case GI_1_4:
+          guard_interval = fft_points / 4;
+          break;
+        case GI_1_128:
+          guard_interval = fft_points / 128;
+          break;
+        case GI_19_128:
+          guard_interval = (fft_points * 19) / 128;
+          break;
+        case GI_19_256:
+          guard_interval = (fft_points * 19) / 256;
+          break;
+      }
+      /* P1 and the P2 and data symbols, in elementary periods T */
+      frame_periods = 2048 + ((uint64_t)mapper.symbols() * (fft_points + guard_interval));
+      switch (bandwidth) {
+        case BANDWIDTH_1_7_MHZ:
+          t_num = 71;
+          t_den = 131;
+          break;
+        case BANDWIDTH_5_0_MHZ:
+          t_num = 7;
+          t_den = 40;
+          break;
+        case BANDWIDTH_6_0_MHZ:
+          t_num = 7;
+          t_den = 48;
+          break;
+        case BANDWIDTH_7_0_MHZ:
+          t_num = 1;
+          t_den = 8;
+          break;
+        case BANDWIDTH_8_0_MHZ:
+          t_num = 7;
+          t_den = 64;
+          break;
+        case BANDWIDTH_10_0_MHZ:
+          t_num = 7;
+          t_den = 80;
+          break;
+        default:
+          t_num = 7;
+          t_den = 64;
+          break;
+      }
+      bandwidth_code = bandwidth;
+      utc_offset = utco;
+      emission_delay = delay;
+      start_seconds = -1;
+      frame_number = 0;
+
+      set_tag_propagation_policy(TPP_DONT);
+      perf_t2mi = perf.add_stage("t2mi");
+      message_port_register_out(pmt::mp(PERF_PORT));
+    }
+
+    /*
+     * Our virtual destructor.
+     */
+    t2miencap_bb_impl::~t2miencap_bb_impl()
+    {
+    }
+
+    void
+    t2miencap_bb_impl::forecast (int noutput_items, gr_vector_int &ninput_items_required)
+    {
+      ninput_items_required[0] = (noutput_items / frame_items) * frame_bits;
+    }
+
+    /* Writes the length low bits of value to packet, MSB first */
+    inline int
+    t2miencap_bb_impl::put_bits(int offset, uint64_t value, int length)
+    {
+      for (int n = length - 1; n >= 0; n--) {
+        packet[offset++] = (value >> n) & 0x1;
+      }
+      return offset;
+    }
+
+    /* Bytes of a T2-MI packet with payload_bits, padded to whole bytes */
+    int
+    t2miencap_bb_impl::packet_bytes(int payload_bits) const
+    {
+      return ((T2MI_HEADER_BITS + payload_bits + 7) / 8) + (T2MI_CRC_BITS / 8);
+    }
+
+    /*
+     * Adds the header, the padding and the CRC-32 to the payload at
+     * packet[T2MI_HEADER_BITS] and appends the packet to frame_data.
+     */
+    void
+    t2miencap_bb_impl::add_packet(int type, int payload_bits)
+    {
+      int bits = T2MI_HEADER_BITS + payload_bits;
+      int offset;
+      unsigned char b;
+
+      offset = put_bits(0, type, 8);
+      offset = put_bits(offset, packet_count, 8);
+      offset = put_bits(offset, superframe_idx, 4);
+      offset = put_bits(offset, 0, 12);
+      put_bits(offset, payload_bits, 16);
+      while (bits % 8 != 0) {
+        packet[bits++] = 0;
+      }
+      bits = put_bits(bits, crc32.compute(&packet[0], bits), T2MI_CRC_BITS);
+      for (int i = 0; i < bits; i += 8) {
+        b = 0;
+        for (int n = 0; n < 8; n++) {
+          b = (b << 1) | packet[i + n];
+        }
+        frame_data[data_offset++] = b;
+      }
+      packet_count = (packet_count + 1) & 0xff;
+    }
+
+    /*
+     * The BBFRAME of the bbheaderbch_bb output at in, without the BCH
+     * parity and the BB scrambling, which the modulator adds again.
+     */
+    void
+    t2miencap_bb_impl::add_bbframe(const unsigned char *in, int first)
+    {
+      int offset;
+
+      offset = put_bits(T2MI_HEADER_BITS, frame_idx, 8);
+      offset = put_bits(offset, mapper.config()->L1_Signalling[0].l1post_data.plp_id, 8);
+      offset = put_bits(offset, first, 1);
+      offset = put_bits(offset, 0, 7);
+      memcpy(&packet[offset], in, kbch);
+      kernels->xor_bytes(&packet[offset], bb_prbs.v, kbch);
+      add_packet(T2MI_PACKET_BB, offset + kbch - T2MI_HEADER_BITS);
+    }
+
+    /*
+     * Absolute timestamp of the frame. The time since the first frame
+     * is frame_number * frame_periods * T, kept in 1 / t_den us so it
+     * stays exact.
+     */
+    void
+    t2miencap_bb_impl::add_timestamp(void)
+    {
+      uint64_t elapsed = frame_number * frame_periods * t_num;
+      uint64_t second = 1000000ULL * t_den;
+      int offset;
+
+      offset = put_bits(T2MI_HEADER_BITS, 0, 4);
+      offset = put_bits(offset, bandwidth_code, 4);
+      offset = put_bits(offset, start_seconds + (elapsed / second), 40);
+      offset = put_bits(offset, (elapsed % second) / t_num, 27);
+      offset = put_bits(offset, utc_offset, 13);
+      add_packet(T2MI_PACKET_TIMESTAMP, offset - T2MI_HEADER_BITS);
+    }
+
+    /* L1-pre, configurable and dynamic L1-post, no L1 extension */
+    void
+    t2miencap_bb_impl::add_l1_current(void)
+    {
+      const frame_mapper_impl::frame_config *fc = mapper.config();
+      int offset, bits, conf_bits;
+
+      offset = put_bits(T2MI_HEADER_BITS, frame_idx, 8);
+      offset = put_bits(offset, 0, 8);
+      offset += mapper.l1pre_bits(fc, &packet[offset]);
+      bits = mapper.l1post_bits(fc, &l1_bits[0], frame_idx, conf_bits);
+      offset = put_bits(offset, conf_bits, 16);
+      memcpy(&packet[offset], &l1_bits[0], conf_bits);
+      offset += conf_bits;
+      offset = put_bits(offset, bits - conf_bits, 16);
+      memcpy(&packet[offset], &l1_bits[conf_bits], bits - conf_bits);
+      offset += bits - conf_bits;
+      offset = put_bits(offset, 0, 16);
+      add_packet(T2MI_PACKET_L1_CURRENT, offset - T2MI_HEADER_BITS);
+    }
+
+    /*
+     * Splits frame_data into TS packets, with the payload unit start
+     * indicator and the pointer field where a T2-MI packet starts and
+     * 0xff stuffing after the last one. A packet that would start on
+     * the last byte can't be pointed to, so that TS packet gets a one
+     * byte adaptation field instead. Returns the number of TS
+     * packets, and only counts them with out NULL.
+     */
+    int
+    t2miencap_bb_impl::ts_packets(unsigned char *out)
+    {
+      int count = 0;
+      int pos = 0;
+      int next = 0;
+      int gap, header, length;
+
+      while (pos < data_length) {
+        while (next < (int)packet_starts.size() && packet_starts[next] < pos) {
+          next++;
+        }
+        gap = next < (int)packet_starts.size() ? packet_starts[next] - pos : TS_PACKET_SIZE;
+        header = gap < TS_PACKET_SIZE - TS_HEADER_SIZE ? TS_HEADER_SIZE + 1 : TS_HEADER_SIZE;
+        length = TS_PACKET_SIZE - header;
+        if (out != NULL) {
+          out[0] = 0x47;
+          out[1] = (ts_pid >> 8) & 0x1f;
+          out[2] = ts_pid & 0xff;
+          out[3] = 0x10 | continuity;
+          if (gap < length) {
+            out[1] |= 0x40;
+            out[4] = gap;
+          }
+          else if (header > TS_HEADER_SIZE) {
+            out[3] |= 0x20;
+            out[4] = 0;
+          }
+          length = std::min(length, data_length - pos);
+          memcpy(&out[header], &frame_data[pos], length);
+          memset(&out[header + length], 0xff, TS_PACKET_SIZE - header - length);
+          continuity = (continuity + 1) & 0xf;
+          out += TS_PACKET_SIZE;
+        }
+        pos += length;
+        count++;
+      }
+      return count;
+    }
+
+    void
+    t2miencap_bb_impl::encapsulate_frame(const unsigned char *in, unsigned char *out)
+    {
+      data_offset = 0;
+      for (int i = 0; i < fec_blocks; i++) {
+        add_bbframe(in, i == 0);
+        in += nbch;
+      }
+      add_timestamp();
+      add_l1_current();
+      ts_packets(out);
+      frame_number++;
+      if (++frame_idx == t2_frames) {
+        frame_idx = 0;
+        superframe_idx = (superframe_idx + 1) & 0xf;
+      }
+    }
+
+    int
+    t2miencap_bb_impl::general_work (int noutput_items,
+                       gr_vector_int &ninput_items,
+                       gr_vector_const_void_star &input_items,
+                       gr_vector_void_star &output_items)
+    {
+      const unsigned char *in = (const unsigned char *) input_items[0];
+      unsigned char *out = (unsigned char *) output_items[0];
+      int frames = std::min(noutput_items / frame_items, ninput_items[0] / frame_bits);
+      double now;
+      gr_vector_int required(1);
+      gr::high_res_timer_type work_start = gr::high_res_timer_now();
+      gr::high_res_timer_type mark;
+      gr::high_res_timer_type end;
+
+      if (start_seconds < 0 && frames > 0) {
+        now = std::chrono::duration<double>(std::chrono::system_clock::now().time_since_epoch()).count();
+        start_seconds = (int64_t)std::ceil(now + emission_delay) - UNIX_TIME_2000 + utc_offset;
+      }
+      for (int i = 0; i < frames; i++) {
+        mark = gr::high_res_timer_now();
+        encapsulate_frame(in, out);
+        perf.lap(perf_t2mi, mark);
+        in += frame_bits;
+        out += frame_items;
+      }
+
+      perf.frames(frames);
+      forecast(frame_items, required);
+      if (ninput_items[0] - (frames * frame_bits) < required[0]) {
+        perf.starved();
+      }
+      end = gr::high_res_timer_now();
+      if (perf.end_call(work_start, end)) {
+        message_port_pub(pmt::mp(PERF_PORT), perf.report(end));
+      }
+
+      // Tell runtime system how many input items we consumed on
+      // each input stream.
+      consume_each (frames * frame_bits);
+
+      // Tell runtime system how many output items we produced.
+      return frames * frame_items;
+    }
+
+  } /* namespace dvbt2ll */
+} /* namespace gr */
+
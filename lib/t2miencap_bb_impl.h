@@ -0,0 +1,117 @@
+/* -*- c++ -*- */
+/* 
+ * Copyright 2017 Ron Economos.
+ * 
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ * 
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_DVBT2LL_T2MIENCAP_BB_IMPL_H
+#define INCLUDED_DVBT2LL_T2MIENCAP_BB_IMPL_H
+
+#include <dvbt2ll/t2miencap_bb.h>
+#include "frame_mapper_impl.h"
+#include "bch_crc_engine.h"
+#include "cpu_dispatch.h"
+#include "perf_counters.h"
+#include <stdint.h>
+#include <vector>
+
+#define T2MI_HEADER_BITS 48
+#define T2MI_CRC_BITS 32
+#define T2MI_PACKET_BB 0x00
+#define T2MI_PACKET_L1_CURRENT 0x10
+#define T2MI_PACKET_TIMESTAMP 0x20
+/* rfu, bw, seconds_since_2000, subseconds and utco */
+#define T2MI_TIMESTAMP_BITS 88
+
+#define TS_PACKET_SIZE 188
+#define TS_HEADER_SIZE 4
+/* 2000-01-01 00:00:00 UTC in seconds since 1970 */
+#define UNIX_TIME_2000 946684800LL
+
+namespace gr {
+  namespace dvbt2ll {
+
+    class t2miencap_bb_impl : public t2miencap_bb
+    {
+     private:
+      /* L1 signalling only, no cells are mapped */
+      frame_mapper_impl mapper;
+      const cpu_kernels *kernels;
+      crc32_engine crc32;
+      int kbch;
+      int nbch;
+      int fec_blocks;
+      int t2_frames;
+      int frame_bits;
+      int frame_items;
+      int ts_pid;
+      int continuity;
+      int packet_count;
+      int superframe_idx;
+      int frame_idx;
+
+      /*
+       * Every T2 frame is sent as the same sequence of T2-MI packets,
+       * so the byte offset of each in frame_data and the TS packets
+       * they take are fixed.
+       */
+      std::vector<unsigned char> packet;
+      std::vector<unsigned char> frame_data;
+      std::vector<int> packet_starts;
+      std::vector<unsigned char> l1_bits;
+      int data_length;
+      int data_offset;
+
+      /* Timestamps, with T = t_num / t_den us */
+      int bandwidth_code;
+      int utc_offset;
+      double emission_delay;
+      int64_t start_seconds;
+      uint64_t frame_number;
+      uint64_t frame_periods;
+      int t_num;
+      int t_den;
+
+      perf_counters perf;
+      int perf_t2mi;
+
+      int put_bits(int, uint64_t, int);
+      int packet_bytes(int) const;
+      void add_packet(int, int);
+      void add_bbframe(const unsigned char *, int);
+      void add_timestamp(void);
+      void add_l1_current(void);
+      int ts_packets(unsigned char *);
+      void encapsulate_frame(const unsigned char *, unsigned char *);
+
+     public:
+      t2miencap_bb_impl(dvbt2_framesize_t framesize, dvbt2_code_rate_t rate, dvbt2_constellation_t constellation, dvbt2_rotation_t rotation, int fecblocks, int tiblocks, dvbt2_extended_carrier_t carriermode, dvbt2_fftsize_t fftsize, dvbt2_guardinterval_t guardinterval, dvbt2_l1constellation_t l1constellation, dvbt2_pilotpattern_t pilotpattern, int t2frames, int numdatasyms, dvbt2_papr_t paprmode, dvbt2_version_t version, dvbt2_preamble_t preamble, dvbt2_inputmode_t inputmode, dvbt2_reservedbiasbits_t reservedbiasbits, dvbt2_l1scrambled_t l1scrambled, dvbt2_inband_t inband, dvbt2_bandwidth_t bandwidth, int pid, double delay, int utco);
+      ~t2miencap_bb_impl();
+
+      void forecast (int noutput_items, gr_vector_int &ninput_items_required);
+
+      int general_work(int noutput_items,
+           gr_vector_int &ninput_items,
+           gr_vector_const_void_star &input_items,
+           gr_vector_void_star &output_items);
+    };
+
+  } // namespace dvbt2ll
+} // namespace gr
+
+#endif /* INCLUDED_DVBT2LL_T2MIENCAP_BB_IMPL_H */
+
@@ -0,0 +1,77 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2017 Ron Economos.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_DVBT2LL_TABLE_CACHE_H
+#define INCLUDED_DVBT2LL_TABLE_CACHE_H
+
+#include <gnuradio/thread/thread.h>
+#include <boost/shared_ptr.hpp>
+#include <boost/weak_ptr.hpp>
+#include <map>
+
+namespace gr {
+  namespace dvbt2ll {
+
+    /*
+     * Process-wide registry of immutable tables, keyed by the
+     * parameters they are built from. All block instances with the
+     * same key share one copy, which is freed with the last of them.
+     *
+     * build() is called with the lock held, so a second instance waits
+     * for the first one's tables instead of building its own. It must
+     * return a new V or throw.
+     */
+    template <class K, class V>
+    class table_cache
+    {
+     private:
+      typedef std::map<K, boost::weak_ptr<const V> > table_map;
+      gr::thread::mutex d_mutex;
+      table_map d_tables;
+
+     public:
+      template <class F>
+      boost::shared_ptr<const V> get(const K &key, F build)
+      {
+        gr::thread::scoped_lock guard(d_mutex);
+        typename table_map::iterator it;
+        boost::shared_ptr<const V> tables;
+
+        for (it = d_tables.begin(); it != d_tables.end(); ) {
+          if (it->second.expired()) {
+            d_tables.erase(it++);
+          }
+          else {
+            ++it;
+          }
+        }
+        tables = d_tables[key].lock();
+        if (!tables) {
+          tables = boost::shared_ptr<const V>(build());
+          d_tables[key] = tables;
+        }
+        return tables;
+      }
+    };
+
+  } // namespace dvbt2ll
+} // namespace gr
+
+#endif /* INCLUDED_DVBT2LL_TABLE_CACHE_H */
@@ -0,0 +1,403 @@
+/* -*- c++ -*- */
+/* 
+ * Copyright 2017 Ron Economos.
+ * 
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ * 
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gnuradio/io_signature.h>
+#include "transmitter_bc_impl.h"
+#include <algorithm>
+#include <stdexcept>
+#include <stdlib.h>
+#include <string.h>
+
+namespace gr {
+  namespace dvbt2ll {
+
+    transmitter_bc::sptr
+    transmitter_bc::make(dvbt2_framesize_t framesize, dvbt2_code_rate_t rate, dvbt2_constellation_t constellation, dvbt2_rotation_t rotation, int fecblocks, int tiblocks, dvbt2_extended_carrier_t carriermode, dvbt2_fftsize_t fftsize, dvbt2_guardinterval_t guardinterval, dvbt2_l1constellation_t l1constellation, dvbt2_pilotpattern_t pilotpattern, int t2frames, int numdatasyms, dvbt2_papr_t paprmode, dvbt2_version_t version, dvbt2_preamble_t preamble, dvbt2_inputmode_t inputmode, dvbt2_reservedbiasbits_t reservedbiasbits, dvbt2_l1scrambled_t l1scrambled, dvbt2_inband_t inband, int tsrate, dvbt2_misogroup_t misogroup, dvbt2_equalization_t equalization, dvbt2_bandwidth_t bandwidth, int vlength, int threads, int cpu)
+    {
+      return gnuradio::get_initial_sptr
+        (new transmitter_bc_impl(framesize, rate, constellation, rotation, fecblocks, tiblocks, carriermode, fftsize, guardinterval, l1constellation, pilotpattern, t2frames, numdatasyms, paprmode, version, preamble, inputmode, reservedbiasbits, l1scrambled, inband, tsrate, misogroup, equalization, bandwidth, vlength, threads, cpu));
+    }
+
+    /*
+     * The private constructor
+     */
+    transmitter_bc_impl::transmitter_bc_impl(dvbt2_framesize_t framesize, dvbt2_code_rate_t rate, dvbt2_constellation_t constellation, dvbt2_rotation_t rotation, int fecblocks, int tiblocks, dvbt2_extended_carrier_t carriermode, dvbt2_fftsize_t fftsize, dvbt2_guardinterval_t guardinterval, dvbt2_l1constellation_t l1constellation, dvbt2_pilotpattern_t pilotpattern, int t2frames, int numdatasyms, dvbt2_papr_t paprmode, dvbt2_version_t version, dvbt2_preamble_t preamble, dvbt2_inputmode_t inputmode, dvbt2_reservedbiasbits_t reservedbiasbits, dvbt2_l1scrambled_t l1scrambled, dvbt2_inband_t inband, int tsrate, dvbt2_misogroup_t misogroup, dvbt2_equalization_t equalization, dvbt2_bandwidth_t bandwidth, int vlength, int threads, int cpu)
+      : gr::block("transmitter_bc",
+              gr::io_signature::make(1, 1, sizeof(unsigned char)),
+              gr::io_signature::make(1, 1, sizeof(gr_complex))),
+        encoder(framesize, rate, inputmode, inband, fecblocks, tsrate),
+        modulator(framesize, rate, constellation, rotation),
+        mapper(framesize, rate, constellation, rotation, fecblocks, tiblocks, carriermode, fftsize, guardinterval, l1constellation, pilotpattern, t2frames, numdatasyms, paprmode, version, preamble, inputmode, reservedbiasbits, l1scrambled, inband),
+        ofdm(carriermode, fftsize, pilotpattern, guardinterval, numdatasyms, paprmode, version, preamble, misogroup, equalization, bandwidth, vlength),
+        running(false)
+    {
+      int num_slots;
+
+      if (misogroup == MISO_TX1_TX2) {
+        throw std::invalid_argument("Transmitter, MISO TX1 and TX2 needs the two outputs of the Pilot Generator");
+      }
+      if (!mapper.fits()) {
+        GR_LOG_WARN(d_logger, "Transmitter, too many FEC blocks in T2 frame.");
+      }
+      logged_sync_errors = 0;
+      fec_blocks = fecblocks;
+      frame_size = encoder.frame_bits();
+      cell_size = modulator.output_items();
+      mapped_items = mapper.output_items();
+      frame_items = ofdm.output_items();
+      ts_count = 0;
+      fec_block = 0;
+
+      num_threads = std::max(0, std::min(threads, (int)STAGES));
+      first_cpu = cpu;
+      first_stage[0] = 0;
+      for (int t = 1; t <= num_threads; t++) {
+        first_stage[t] = ((t * STAGES) + num_threads - 1) / num_threads;
+      }
+      /* one frame per stage thread, one being handed in and one handed out */
+      num_slots = num_threads + 2;
+      slots.resize(num_slots);
+      for (int i = 0; i < num_slots; i++) {
+        frame_slot &slot = slots[i];
+        slot.ts = (unsigned char *) frame_buffer_alloc(sizeof(unsigned char) * fec_blocks * (frame_size / 8));
+        slot.fec = (unsigned char *) frame_buffer_alloc(sizeof(unsigned char) * fec_blocks * frame_size);
+        slot.cells = (gr_complex *) frame_buffer_alloc(sizeof(gr_complex) * fec_blocks * cell_size);
+        slot.mapped = (gr_complex *) frame_buffer_alloc(sizeof(gr_complex) * mapped_items);
+        slot.iq = (gr_complex *) frame_buffer_alloc(sizeof(gr_complex) * frame_items);
+        if (slot.ts == NULL || slot.fec == NULL || slot.cells == NULL || slot.mapped == NULL || slot.iq == NULL) {
+          for (int j = 0; j <= i; j++) {
+            frame_buffer_free(slots[j].ts);
+            frame_buffer_free(slots[j].fec);
+            frame_buffer_free(slots[j].cells);
+            frame_buffer_free(slots[j].mapped);
+            frame_buffer_free(slots[j].iq);
+          }
+          GR_LOG_FATAL(d_logger, "Transmitter, cannot allocate memory for the frame pool.");
+          throw std::bad_alloc();
+        }
+        idle_slots.push_back(&slot);
+      }
+      in_flight = 0;
+      for (int t = 0; t <= num_threads; t++) {
+        queues.push_back(boost::shared_ptr<frame_queue>(new frame_queue(num_slots)));
+      }
+
+      perf_stage[STAGE_FEC] = perf.add_stage("fec");
+      perf_stage[STAGE_MODULATE] = perf.add_stage("modulate");
+      perf_stage[STAGE_MAP] = perf.add_stage("map");
+      perf_stage[STAGE_OFDM] = perf.add_stage("ofdm");
+      message_port_register_out(pmt::mp(PERF_PORT));
+      set_tag_propagation_policy(TPP_DONT);
+      set_output_multiple(frame_items);
+    }
+
+    /*
+     * Our virtual destructor.
+     */
+    transmitter_bc_impl::~transmitter_bc_impl()
+    {
+      stop_threads();
+      for (size_t i = 0; i < slots.size(); i++) {
+        frame_buffer_free(slots[i].ts);
+        frame_buffer_free(slots[i].fec);
+        frame_buffer_free(slots[i].cells);
+        frame_buffer_free(slots[i].mapped);
+        frame_buffer_free(slots[i].iq);
+      }
+    }
+
+    void
+    transmitter_bc_impl::frame_queue::push(frame_slot *slot)
+    {
+      d_queue.push(slot);
+      boost::atomic_thread_fence(boost::memory_order_seq_cst);
+      if (d_parked.load()) {
+        gr::thread::scoped_lock guard(d_mutex);
+        d_cond.notify_one();
+      }
+    }
+
+    /*
+     * Returns false once running is cleared and the queue is empty.
+     * The consumer only parks while holding the mutex, and push()
+     * takes it before notifying, so a wake-up can't get lost.
+     */
+    bool
+    transmitter_bc_impl::frame_queue::wait_pop(frame_slot *&slot, const boost::atomic<bool> &running)
+    {
+      for (int i = 0; i < QUEUE_SPIN; i++) {
+        if (d_queue.pop(slot)) {
+          return true;
+        }
+        boost::this_thread::yield();
+      }
+      gr::thread::scoped_lock guard(d_mutex);
+      d_parked.store(true);
+      boost::atomic_thread_fence(boost::memory_order_seq_cst);
+      while (!d_queue.pop(slot)) {
+        if (!running.load()) {
+          d_parked.store(false);
+          return false;
+        }
+        d_cond.wait(guard);
+      }
+      d_parked.store(false);
+      return true;
+    }
+
+    void
+    transmitter_bc_impl::frame_queue::wake(void)
+    {
+      gr::thread::scoped_lock guard(d_mutex);
+      d_cond.notify_all();
+    }
+
+    bool
+    transmitter_bc_impl::start()
+    {
+      if (num_threads > 0 && !running.load()) {
+        running.store(true);
+        for (int t = 0; t < num_threads; t++) {
+          stage_threads.create_thread(boost::bind(&transmitter_bc_impl::stage_loop, this, t));
+        }
+      }
+      return block::start();
+    }
+
+    bool
+    transmitter_bc_impl::stop()
+    {
+      stop_threads();
+      return block::stop();
+    }
+
+    /*
+     * The stage threads finish the frame they are on, so afterwards
+     * every frame is in a queue. Their TS has already been consumed,
+     * so the frames that are left halfway are finished here, oldest
+     * first, and handed out after a restart.
+     */
+    void
+    transmitter_bc_impl::stop_threads(void)
+    {
+      frame_slot *slot;
+
+      if (running.load()) {
+        running.store(false);
+        for (size_t i = 0; i < queues.size(); i++) {
+          queues[i]->wake();
+        }
+        stage_threads.join_all();
+        for (int t = num_threads - 1; t >= 0; t--) {
+          while (queues[t]->pop(slot)) {
+            run_stages(slot, first_stage[t], STAGES);
+            queues[num_threads]->push(slot);
+          }
+        }
+      }
+    }
+
+    void
+    transmitter_bc_impl::stage_loop(int thread)
+    {
+      frame_slot *slot;
+
+      if (first_cpu >= 0) {
+        gr::thread::thread_bind_to_processor(first_cpu + thread);
+        place_buffers(thread);
+      }
+      while (queues[thread]->wait_pop(slot, running)) {
+        run_stages(slot, first_stage[thread], first_stage[thread + 1]);
+        queues[thread + 1]->push(slot);
+      }
+    }
+
+    /*
+     * Moves what the stages of a pinned thread write to the NUMA node
+     * of its CPU. The TS is written by the scheduler thread.
+     */
+    void
+    transmitter_bc_impl::place_buffers(int thread)
+    {
+      for (size_t i = 0; i < slots.size(); i++) {
+        frame_slot &slot = slots[i];
+        void *written[STAGES] = {slot.fec, slot.cells, slot.mapped, slot.iq};
+
+        for (int s = first_stage[thread]; s < first_stage[thread + 1]; s++) {
+          frame_buffer_place(written[s], first_cpu + thread);
+        }
+      }
+    }
+
+    /*
+     * Runs stages [begin, end) on one T2 frame and keeps the time each
+     * took in the frame, to be added to the counters when it leaves.
+     */
+    void
+    transmitter_bc_impl::run_stages(frame_slot *slot, int begin, int end)
+    {
+      gr::high_res_timer_type mark = gr::high_res_timer_now();
+      gr::high_res_timer_type now;
+      const unsigned char *ts;
+      unsigned char *fec;
+
+      for (int s = begin; s < end; s++) {
+        switch (s) {
+          case STAGE_FEC:
+            ts = slot->ts;
+            fec = slot->fec;
+            for (int b = 0; b < fec_blocks; b++) {
+              ts += encoder.encode_frame(ts, fec);
+              encoder.ldpc_encode(fec);
+              fec += frame_size;
+            }
+            /* only the thread of this stage touches the encoder */
+            for (; logged_sync_errors < encoder.sync_errors(); logged_sync_errors++) {
+              GR_LOG_WARN(d_logger, "Transport Stream sync error!");
+            }
+            break;
+          case STAGE_MODULATE:
+            modulator.process(slot->fec, slot->cells, fec_blocks);
+            break;
+          case STAGE_MAP:
+            mapper.process(slot->cells, slot->mapped, 1);
+            break;
+          case STAGE_OFDM:
+            ofdm.process(slot->mapped, slot->iq, 1);
+            break;
+        }
+        now = gr::high_res_timer_now();
+        slot->ticks[s] = now - mark;
+        mark = now;
+      }
+    }
+
+    /* TS bytes of the next T2 frame, see bbframe_encoder_impl::frame_input_items() */
+    int
+    transmitter_bc_impl::frame_input_items(unsigned int &count, int &block) const
+    {
+      int items = 0;
+
+      for (int b = 0; b < fec_blocks; b++) {
+        items += encoder.frame_input_items(count, block);
+      }
+      return items;
+    }
+
+    void
+    transmitter_bc_impl::forecast (int noutput_items, gr_vector_int &ninput_items_required)
+    {
+      unsigned int count = ts_count;
+      int block = fec_block;
+      int frames = std::min(std::max(noutput_items / frame_items, 1), (int)idle_slots.size());
+
+      /* frames on their way can be handed out without new input */
+      ninput_items_required[0] = 0;
+      if (in_flight == 0) {
+        for (int i = 0; i < frames; i++) {
+          ninput_items_required[0] += frame_input_items(count, block);
+        }
+      }
+    }
+
+    int
+    transmitter_bc_impl::general_work (int noutput_items,
+                       gr_vector_int &ninput_items,
+                       gr_vector_const_void_star &input_items,
+                       gr_vector_void_star &output_items)
+    {
+      const unsigned char *in = (const unsigned char *) input_items[0];
+      gr_complex *out = (gr_complex *) output_items[0];
+      frame_queue *done = queues[num_threads].get();
+      int consumed = 0;
+      int produced = 0;
+      int items;
+      unsigned int count;
+      int block;
+      frame_slot *slot;
+      gr::high_res_timer_type work_start = gr::high_res_timer_now();
+      gr::high_res_timer_type now;
+
+      /* hand in a T2 frame for every idle slot there is TS for */
+      while (!idle_slots.empty()) {
+        count = ts_count;
+        block = fec_block;
+        items = frame_input_items(count, block);
+        if (ninput_items[0] - consumed < items) {
+          break;
+        }
+        slot = idle_slots.back();
+        idle_slots.pop_back();
+        memcpy(slot->ts, &in[consumed], sizeof(unsigned char) * items);
+        consumed += items;
+        ts_count = count;
+        fec_block = block;
+        in_flight++;
+        /* without stage threads the frame is done before it's queued */
+        if (!running.load()) {
+          run_stages(slot, 0, STAGES);
+          done->push(slot);
+        }
+        else {
+          queues[0]->push(slot);
+        }
+      }
+
+      /* hand out finished frames, waiting for the first if need be */
+      while (in_flight > 0 && produced + frame_items <= noutput_items) {
+        if (!done->pop(slot)) {
+          if (produced > 0 || !done->wait_pop(slot, running)) {
+            break;
+          }
+        }
+        memcpy(&out[produced], slot->iq, sizeof(gr_complex) * frame_items);
+        for (int s = 0; s < STAGES; s++) {
+          perf.add(perf_stage[s], slot->ticks[s]);
+        }
+        perf.frames(1);
+        idle_slots.push_back(slot);
+        in_flight--;
+        produced += frame_items;
+      }
+
+      count = ts_count;
+      block = fec_block;
+      if (ninput_items[0] - consumed < frame_input_items(count, block)) {
+        perf.starved();
+      }
+      now = gr::high_res_timer_now();
+      if (perf.end_call(work_start, now)) {
+        message_port_pub(pmt::mp(PERF_PORT), perf.report(now));
+      }
+
+      // Tell runtime system how many input items we consumed on
+      // each input stream.
+      consume_each (consumed);
+
+      // Tell runtime system how many output items we produced.
+      return produced;
+    }
+
+  } /* namespace dvbt2ll */
+} /* namespace gr */
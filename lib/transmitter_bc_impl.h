@@ -0,0 +1,137 @@
+/* -*- c++ -*- */
+/* 
+ * Copyright 2017 Ron Economos.
+ * 
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ * 
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_DVBT2LL_TRANSMITTER_BC_IMPL_H
+#define INCLUDED_DVBT2LL_TRANSMITTER_BC_IMPL_H
+
+#include <dvbt2ll/transmitter_bc.h>
+#include "bbframe_encoder_impl.h"
+#include "cell_modulator_impl.h"
+#include "frame_mapper_impl.h"
+#include "ofdm_modulator_impl.h"
+#include "perf_counters.h"
+#include "frame_buffer.h"
+#include <gnuradio/thread/thread.h>
+#include <boost/atomic.hpp>
+#include <boost/lockfree/spsc_queue.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/bind.hpp>
+#include <vector>
+
+/* Polls of an empty queue before a stage thread goes to sleep */
+#define QUEUE_SPIN 1000
+
+namespace gr {
+  namespace dvbt2ll {
+
+    class transmitter_bc_impl : public transmitter_bc
+    {
+     private:
+      enum {
+        STAGE_FEC = 0,
+        STAGE_MODULATE,
+        STAGE_MAP,
+        STAGE_OFDM,
+        STAGES
+      };
+
+      /* All the buffers one T2 frame needs on its way through */
+      struct frame_slot
+      {
+        unsigned char *ts;
+        unsigned char *fec;
+        gr_complex *cells;
+        gr_complex *mapped;
+        gr_complex *iq;
+        gr::high_res_timer_type ticks[STAGES];
+      };
+
+      /*
+       * Lock-free single producer, single consumer queue of frames. A
+       * consumer that finds it empty for a while sleeps until the
+       * producer pushes again.
+       */
+      class frame_queue
+      {
+       private:
+        boost::lockfree::spsc_queue<frame_slot *> d_queue;
+        boost::atomic<bool> d_parked;
+        gr::thread::mutex d_mutex;
+        gr::thread::condition_variable d_cond;
+
+       public:
+        frame_queue(int size) : d_queue(size), d_parked(false) {}
+        void push(frame_slot *);
+        bool pop(frame_slot *&slot) { return d_queue.pop(slot); }
+        bool wait_pop(frame_slot *&, const boost::atomic<bool> &);
+        void wake(void);
+      };
+
+      bbframe_encoder_impl encoder;
+      cell_modulator_impl modulator;
+      frame_mapper_impl mapper;
+      ofdm_modulator_impl ofdm;
+      uint64_t logged_sync_errors;
+
+      int fec_blocks;
+      int frame_size;
+      int cell_size;
+      int mapped_items;
+      int frame_items;
+      unsigned int ts_count;
+      int fec_block;
+      int frame_input_items(unsigned int &, int &) const;
+
+      std::vector<frame_slot> slots;
+      std::vector<frame_slot *> idle_slots;
+      int in_flight;
+      void run_stages(frame_slot *, int, int);
+
+      int num_threads;
+      int first_cpu;
+      int first_stage[STAGES + 1];
+      std::vector<boost::shared_ptr<frame_queue> > queues;
+      gr::thread::thread_group stage_threads;
+      boost::atomic<bool> running;
+      void stage_loop(int);
+      void place_buffers(int);
+      void stop_threads(void);
+
+      perf_counters perf;
+      int perf_stage[STAGES];
+
+     public:
+      transmitter_bc_impl(dvbt2_framesize_t framesize, dvbt2_code_rate_t rate, dvbt2_constellation_t constellation, dvbt2_rotation_t rotation, int fecblocks, int tiblocks, dvbt2_extended_carrier_t carriermode, dvbt2_fftsize_t fftsize, dvbt2_guardinterval_t guardinterval, dvbt2_l1constellation_t l1constellation, dvbt2_pilotpattern_t pilotpattern, int t2frames, int numdatasyms, dvbt2_papr_t paprmode, dvbt2_version_t version, dvbt2_preamble_t preamble, dvbt2_inputmode_t inputmode, dvbt2_reservedbiasbits_t reservedbiasbits, dvbt2_l1scrambled_t l1scrambled, dvbt2_inband_t inband, int tsrate, dvbt2_misogroup_t misogroup, dvbt2_equalization_t equalization, dvbt2_bandwidth_t bandwidth, int vlength, int threads, int cpu);
+      ~transmitter_bc_impl();
+
+      void forecast (int noutput_items, gr_vector_int &ninput_items_required);
+      bool start();
+      bool stop();
+
+      int general_work(int noutput_items,
+           gr_vector_int &ninput_items,
+           gr_vector_const_void_star &input_items,
+           gr_vector_void_star &output_items);
+    };
+
+  } // namespace dvbt2ll
+} // namespace gr
+
+#endif /* INCLUDED_DVBT2LL_TRANSMITTER_BC_IMPL_H */
@@ -13,6 +13,9 @@
 #include "dvbt2ll/interleavermod_bc.h"
 #include "dvbt2ll/framemapperfint_cc.h"
 #include "dvbt2ll/pilotgenp1insert_cc.h"
+#include "dvbt2ll/transmitter_bc.h"
+#include "dvbt2ll/loopplayout_c.h"
+#include "dvbt2ll/t2miencap_bb.h"
 %}
 
 
@@ -25,3 +28,9 @@ GR_SWIG_BLOCK_MAGIC2(dvbt2ll, interleavermod_bc);
 GR_SWIG_BLOCK_MAGIC2(dvbt2ll, framemapperfint_cc);
 %include "dvbt2ll/pilotgenp1insert_cc.h"
 GR_SWIG_BLOCK_MAGIC2(dvbt2ll, pilotgenp1insert_cc);
+%include "dvbt2ll/transmitter_bc.h"
+GR_SWIG_BLOCK_MAGIC2(dvbt2ll, transmitter_bc);
+%include "dvbt2ll/loopplayout_c.h"
+GR_SWIG_BLOCK_MAGIC2(dvbt2ll, loopplayout_c);
+%include "dvbt2ll/t2miencap_bb.h"
+GR_SWIG_BLOCK_MAGIC2(dvbt2ll, t2miencap_bb);